@@ -0,0 +1,8 @@
+#pragma once
+
+// Shared between the driver's source files, not part of the public API
+
+#include "include/RA8875.h"
+
+// Keeps err as the context's error if it's the first since the last RA8875_take_error. Returns err.
+esp_err_t RA8875_record_error(RA8875_context_t* ctx, esp_err_t err);
@@ -1,6 +1,8 @@
 #include "include/RA8875.h"
 #include "include/RA8875_registers.h"
+#include "RA8875_internal.h"
 #include "driver/gpio.h"
+#include "freertos/task.h"
 
 static void set_bte_src(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer) {
     RA8875_write_register(ctx, 0x54, x);
@@ -30,6 +32,13 @@ static void set_bte_foreground(RA8875_context_t* ctx, uint8_t color) {
     RA8875_write_register(ctx, 0x65, (color >> 6) & 0b11);
 }
 
+static void set_bte_background(RA8875_context_t* ctx, uint8_t color) {
+    //Same 3:3:2 layout as the foreground color
+    RA8875_write_register(ctx, 0x60, (color >> 0) & 0b111);
+    RA8875_write_register(ctx, 0x61, (color >> 3) & 0b111);
+    RA8875_write_register(ctx, 0x62, (color >> 6) & 0b11);
+}
+
 static void set_bte_opcode(RA8875_context_t* ctx, uint8_t opcode, uint8_t rop) {
     RA8875_write_register(ctx, 0x51, opcode | (rop << 4));
 }
@@ -38,30 +47,31 @@ static void exec_bte(RA8875_context_t* ctx) {
     RA8875_write_register(ctx, 0x50, 1 << 7); // execute
 }
 
-static void wait_for_interrupt(RA8875_context_t* ctx, uint8_t mask) {
-    // This won't take long, so just spinlock until it's found
+static esp_err_t wait_for_interrupt(RA8875_context_t* ctx, uint8_t mask) {
+    // Queued writes (including the execute) have to be out first
     uint8_t status;
-    do {
-        while (gpio_get_level(ctx->pin_int)); // active low
+    TimeOut_t timeout;
+    TickType_t remaining = pdMS_TO_TICKS(RA8875_BTE_TIMEOUT_MS);
+    RA8875_flush(ctx);
+    vTaskSetTimeOutState(&timeout);
+
+    while (1) {
+        // INT is active low and stays asserted until its flags are cleared, so only block while it's high.
+        // An edge between the level check and the take leaves the semaphore given, so it can't be missed.
+        if (gpio_get_level(ctx->pin_int)) {
+            if (xTaskCheckForTimeOut(&timeout, &remaining))
+                return RA8875_record_error(ctx, ESP_ERR_TIMEOUT);
+            if (ctx->int_sem)
+                xSemaphoreTake(ctx->int_sem, remaining);
+            else
+                vTaskDelay(1);
+            continue;
+        }
+
         status = RA8875_read_register(ctx, 0xF1); // query
         RA8875_write_register(ctx, 0xF1, status); // clear
-    } while (!(status & mask));    
-}
-
-// ADDED BY WISCONSIN RACING
-static void wait_for_interrupt_polling(RA8875_context_t* ctx, uint8_t mask) {
-    uint8_t status;
-    int max_polls = 1000;
-    int polls = 0;
-    
-    while (polls < max_polls) {
-        status = RA8875_read_register(ctx, 0xF1);
-        if (status & mask) {
-            RA8875_write_register(ctx, 0xF1, status);
-            return;
-        }
-        vTaskDelay(pdMS_TO_TICKS(1));
-        polls++;
+        if (status & mask)
+            return ESP_OK;
     }
 }
 
@@ -69,18 +79,15 @@ static void wait_for_interrupt_polling(RA8875_context_t* ctx, uint8_t mask) {
 #define INT_BTE_RW 1
 #define INT_BTE_COMPLETED (1 << 1)
 
-void RA8875_bte_write(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t rop, uint8_t* data) {
-    //Calculate total length
-    int len = (int)width * (int)height;
-
-    //Setup
-    set_bte_dst(ctx, x, y, layer);
-    set_bte_size(ctx, width, height);
-    set_bte_opcode(ctx, 0x00, rop);
-    exec_bte(ctx);
+#define BTE_OP_COLOR_EXPAND 0x08
+#define BTE_OP_COLOR_EXPAND_TRANSPARENT 0x09
+#define BTE_EXPAND_START_BIT 7 // For an 8-bit bus, expansion starts from the MSB of each byte
 
+static esp_err_t transfer_bte_data(RA8875_context_t* ctx, const uint8_t* data, int len) {
     //Wait for interrupt
-    wait_for_interrupt(ctx, INT_BTE_RW);
+    esp_err_t ret = wait_for_interrupt(ctx, INT_BTE_RW);
+    if (ret != ESP_OK)
+        return ret;
 
     //Transfer image data in blocks
     int offset = 0;
@@ -95,27 +102,105 @@ void RA8875_bte_write(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t lay
         RA8875_write_data_block(ctx, &data[offset], blockLen);
 
         //Wait for interrupt
-        wait_for_interrupt(ctx, INT_BTE_RW);
+        ret = wait_for_interrupt(ctx, INT_BTE_RW);
+        if (ret != ESP_OK)
+            return ret;
 
         //Update state
         offset += blockLen;
     }
+    return ESP_OK;
+}
+
+esp_err_t RA8875_bte_write(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t rop, uint8_t* data) {
+    //Setup
+    set_bte_dst(ctx, x, y, layer);
+    set_bte_size(ctx, width, height);
+    set_bte_opcode(ctx, 0x00, rop);
+    exec_bte(ctx);
+
+    //Send pixels
+    return transfer_bte_data(ctx, data, (int)width * (int)height);
+}
+
+esp_err_t RA8875_bte_expand(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t fg, uint8_t bg, uint8_t transparent, const uint8_t* bits) {
+    //Setup
+    set_bte_dst(ctx, x, y, layer);
+    set_bte_size(ctx, width, height);
+    set_bte_foreground(ctx, fg);
+    set_bte_background(ctx, bg);
+    set_bte_opcode(ctx, transparent ? BTE_OP_COLOR_EXPAND_TRANSPARENT : BTE_OP_COLOR_EXPAND, BTE_EXPAND_START_BIT);
+    exec_bte(ctx);
+
+    //Send bits, each row padded to a whole byte
+    return transfer_bte_data(ctx, bits, ((width + 7) / 8) * (int)height);
+}
+
+// Starts the BTE without waiting for it. Nothing may be written until it's done, so the next write waits on it like the draw engines.
+static RA8875_bte_handle_t start_bte(RA8875_context_t* ctx, RA8875_bte_callback_t callback, void* arg) {
+    //Completion is the falling INT edge. A flag left over from an earlier BTE would hold INT low, so there'd be no edge and the wait would return early.
+    RA8875_write_register(ctx, 0xF1, 0xFF); // clear
+    ctx->bte_callback_arg = arg;
+    ctx->bte_callback = callback;
+    exec_bte(ctx);
+    ctx->pending |= RA8875_PENDING_BTE;
+
+    //A queued execute would only go out with the next write, after the CPU work it's supposed to overlap
+    RA8875_flush(ctx);
+    return ++ctx->bte_started;
+}
+
+esp_err_t RA8875_bte_wait(RA8875_context_t* ctx, RA8875_bte_handle_t handle) {
+    //Handles count up and only one BTE runs at a time, so anything up to the last completion is done
+    if ((int32_t)(handle - ctx->bte_completed) <= 0)
+        return ESP_OK;
+
+    ctx->pending &= ~RA8875_PENDING_BTE;
+    esp_err_t ret = wait_for_interrupt(ctx, INT_BTE_COMPLETED);
+    ctx->bte_completed = ctx->bte_started;
+
+    //Without the INT interrupt, nobody else is going to call it
+    RA8875_bte_callback_t callback = ctx->bte_callback;
+    if (!ctx->int_sem && callback) {
+        ctx->bte_callback = NULL;
+        callback(ctx->bte_callback_arg);
+    }
+    return ret;
 }
 
-void RA8875_bte_move(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t negative, uint8_t rop) {
+RA8875_bte_handle_t RA8875_bte_move_async(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t negative, uint8_t rop, RA8875_bte_callback_t callback, void* arg) {
     set_bte_src(ctx, srcX, srcY, srcLayer);
     set_bte_dst(ctx, dstX, dstY, dstLayer);
     set_bte_size(ctx, width, height);
     set_bte_opcode(ctx, negative ? 0x3 : 0x2, rop);
-    exec_bte(ctx);
-    wait_for_interrupt_polling(ctx, INT_BTE_COMPLETED);
+    return start_bte(ctx, callback, arg);
 }
 
-void RA8875_bte_fill(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t color) {
+RA8875_bte_handle_t RA8875_bte_move_transparent_async(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t keyColor, RA8875_bte_callback_t callback, void* arg) {
+    set_bte_src(ctx, srcX, srcY, srcLayer);
+    set_bte_dst(ctx, dstX, dstY, dstLayer);
+    set_bte_size(ctx, width, height);
+    set_bte_foreground(ctx, keyColor); // transparent moves key on the foreground color
+    set_bte_opcode(ctx, 0x5, RA8875_ROP_SRC);
+    return start_bte(ctx, callback, arg);
+}
+
+RA8875_bte_handle_t RA8875_bte_fill_async(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t color, RA8875_bte_callback_t callback, void* arg) {
     set_bte_dst(ctx, x, y, layer);
     set_bte_size(ctx, width, height);
     set_bte_opcode(ctx, 0x0C, 0);
     set_bte_foreground(ctx, color);
-    exec_bte(ctx);
-    wait_for_interrupt(ctx, INT_BTE_COMPLETED);
-}
\ No newline at end of file
+    return start_bte(ctx, callback, arg);
+}
+
+esp_err_t RA8875_bte_move(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t negative, uint8_t rop) {
+    return RA8875_bte_wait(ctx, RA8875_bte_move_async(ctx, srcX, srcY, srcLayer, dstX, dstY, dstLayer, width, height, negative, rop, NULL, NULL));
+}
+
+esp_err_t RA8875_bte_move_transparent(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t keyColor) {
+    return RA8875_bte_wait(ctx, RA8875_bte_move_transparent_async(ctx, srcX, srcY, srcLayer, dstX, dstY, dstLayer, width, height, keyColor, NULL, NULL));
+}
+
+esp_err_t RA8875_bte_fill(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t color) {
+    return RA8875_bte_wait(ctx, RA8875_bte_fill_async(ctx, x, y, layer, width, height, color, NULL, NULL));
+}
@@ -1,16 +1,71 @@
 #include "include/RA8875.h"
 #include "include/RA8875_registers.h"
 #include "driver/gpio.h"
+#include "hal/gpio_ll.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #include <string.h>
 #include <stdio.h>
 
+static void IRAM_ATTR int_isr(void* arg) {
+    RA8875_context_t* ctx = (RA8875_context_t*)arg;
+    BaseType_t woken = pdFALSE;
+
+    //A callback is only set while an async BTE runs, and nothing else can start until it's done, so this edge is its completion
+    RA8875_bte_callback_t callback = ctx->bte_callback;
+    if (callback) {
+        ctx->bte_callback = NULL;
+        callback(ctx->bte_callback_arg);
+    }
+
+    xSemaphoreGiveFromISR(ctx->int_sem, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Both SPI devices talk to the same chip, so CS is a plain GPIO toggled around every transaction rather than owned by either device.
+// These run from the SPI interrupt, which can fire while the flash cache is off, so they go straight to the GPIO registers: gpio_set_level lives in flash.
+static void IRAM_ATTR cs_assert(spi_transaction_t* t) {
+    gpio_ll_set_level(&GPIO, ((RA8875_context_t*)t->user)->pin_cs, 0);
+}
+
+static void IRAM_ATTR cs_release(spi_transaction_t* t) {
+    gpio_ll_set_level(&GPIO, ((RA8875_context_t*)t->user)->pin_cs, 1);
+}
+
+static esp_err_t add_device(RA8875_context_t* ctx, int speed, int queueSize, spi_device_handle_t* handle) {
+    spi_device_interface_config_t devcfg = {
+        .command_bits = 8,
+        .address_bits = 0,
+        .dummy_bits = 0,
+        .clock_speed_hz = speed,
+        .duty_cycle_pos = 128,
+        .mode = 0,
+        .spics_io_num = -1,
+        .queue_size = queueSize,
+        .pre_cb = cs_assert,
+        .post_cb = cs_release
+    };
+    return spi_bus_add_device(ctx->host, &devcfg, handle);
+}
+
+static void enable_interrupts(RA8875_context_t* ctx) {
+    //Enable BTE interrupts
+    RA8875_write_register(ctx, 0xF0, 0b11); //enable
+    RA8875_write_register(ctx, 0xF1, 0xFF); //clear
+}
+
 int RA8875_init(RA8875_context_t* ctx, int host, int speed, int pinMosi, int pinMiso, int pinSclk, int pinCs, int pinInt) {
     //Clear context
     memset(ctx, 0, sizeof(RA8875_context_t));
+    ctx->host = host;
+    ctx->pin_cs = pinCs;
     ctx->pin_int = pinInt;
+    ctx->read_speed = speed;
+    ctx->write_speed = speed;
+    ctx->fast_path = RA8875_LL_FAST_PATH;
 
     //Initialize SPI bus
     spi_bus_config_t bus_cfg = {
@@ -19,24 +74,31 @@ int RA8875_init(RA8875_context_t* ctx, int host, int speed, int pinMosi, int pin
         .sclk_io_num = pinSclk,
         .quadwp_io_num = -1,
         .quadhd_io_num = -1,
-        .max_transfer_sz = 8000,
+        .max_transfer_sz = RA8875_MAX_TRANSFER,
     };
     if (spi_bus_initialize(host, &bus_cfg, SPI_DMA_CH_AUTO) != ESP_OK)
         return 0;
 
-    //Initialize SPI device
-    spi_device_interface_config_t devcfg = {
-        .command_bits = 8,
-        .address_bits = 0,
-        .dummy_bits = 0,
-        .clock_speed_hz = speed,
-        .duty_cycle_pos = 128,
-        .mode = 0,
-        .spics_io_num = pinCs,
-        .queue_size = 3
+    //Chip select, idle high
+    gpio_config_t csConf = {
+        .pin_bit_mask = 1ULL << pinCs,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
     };
-    if (spi_bus_add_device(host, &devcfg, &ctx->spi_device) != ESP_OK)
+    gpio_config(&csConf);
+    gpio_set_level(pinCs, 1);
+
+    //Initialize SPI devices. Both start at the init speed; the PLL isn't running yet, so nothing faster works.
+    if (add_device(ctx, speed, 1, &ctx->spi_device) != ESP_OK)
+        return 0;
+    if (add_device(ctx, speed, RA8875_QUEUE_DEPTH, &ctx->spi_write_device) != ESP_OK)
         return 0;
+
+    //Bounce buffers for streaming data that DMA can't read directly. Streams still work without them, the SPI driver just copies each chunk itself.
+    for (int i = 0; i < 2; i++)
+        ctx->stream_buf[i] = heap_caps_malloc(RA8875_STREAM_CHUNK, MALLOC_CAP_DMA);
     
     //Configure interrupt GPIO pin
     gpio_config_t pinConf = {
@@ -44,24 +106,92 @@ int RA8875_init(RA8875_context_t* ctx, int host, int speed, int pinMosi, int pin
         .mode = GPIO_MODE_INPUT,
         .pull_up_en = GPIO_PULLUP_DISABLE,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
+        .intr_type = GPIO_INTR_NEGEDGE // active low
     };
     gpio_config(&pinConf);
 
+    //Wake BTE waits from the INT pin. The ISR service may already be installed by the application, which is fine.
+    ctx->int_sem = xSemaphoreCreateBinary();
+    esp_err_t err = gpio_install_isr_service(0);
+    if (ctx->int_sem && (err == ESP_OK || err == ESP_ERR_INVALID_STATE))
+        err = gpio_isr_handler_add(pinInt, int_isr, ctx);
+    if (!ctx->int_sem || err != ESP_OK) {
+        printf("WARNING: Couldn't install the INT pin interrupt (%d). BTE waits will poll instead.\n", err);
+        if (ctx->int_sem)
+            vSemaphoreDelete(ctx->int_sem);
+        ctx->int_sem = NULL;
+    }
+
     //Test SPI connection; sometimes the screen just takes a bit to boot?
     while (RA8875_read_register(ctx, 0) != 0x75) {
         printf("ERROR: Got invalid value reading register 0x75. Check the SPI connection. Retrying...\n");
         vTaskDelay(100 / portTICK_PERIOD_MS);
     }
 
-    //Enable BTE interrupts
-    RA8875_write_register(ctx, 0xF0, 0b11); //enable
-    RA8875_write_register(ctx, 0xF1, 0xFF); //clear
+    enable_interrupts(ctx);
+    return 1;
+}
+
+esp_err_t RA8875_set_write_speed(RA8875_context_t* ctx, int speed) {
+    //The clock is fixed per device, so swap the write device for one at the new speed
+    RA8875_flush(ctx);
+    spi_bus_remove_device(ctx->spi_write_device);
+    esp_err_t ret = add_device(ctx, speed, RA8875_QUEUE_DEPTH, &ctx->spi_write_device);
+    if (ret != ESP_OK) {
+        //Fall back to the read clock, which is known to work
+        speed = ctx->read_speed;
+        add_device(ctx, speed, RA8875_QUEUE_DEPTH, &ctx->spi_write_device);
+    }
+    ctx->write_speed = speed;
+    return ret;
+}
+
+// Writes a pattern to the BTE source/destination X registers (rewritten by every BTE, so harmless) and reads it back at the read clock
+static int write_pattern_ok(RA8875_context_t* ctx) {
+    static const uint8_t pattern[] = { 0x00, 0xFF, 0x55, 0xAA, 0x0F, 0xF0, 0x3C, 0xC3 };
+    static const uint8_t scratch[] = { 0x54, 0x58 };
 
+    for (int round = 0; round < 4; round++) {
+        for (size_t i = 0; i < sizeof(pattern); i++) {
+            for (size_t r = 0; r < sizeof(scratch); r++) {
+                uint8_t value = pattern[(i + r) % sizeof(pattern)] ^ round;
+
+                //The shadow could skip the write, or hold what a garbled write left behind
+                RA8875_invalidate_shadow(ctx);
+                RA8875_write_register(ctx, scratch[r], value);
+                if (RA8875_read_register(ctx, scratch[r]) != value)
+                    return 0;
+            }
+        }
+    }
     return 1;
 }
 
-void RA8875_configure(RA8875_context_t* ctx, uint8_t hsync_nondisp, uint8_t hsync_start, uint8_t hsync_pw, uint8_t hsync_finetune, uint16_t vsync_nondisp, uint16_t vsync_start, uint8_t vsync_pw, uint16_t width, uint16_t height, uint16_t voffset) {
+int RA8875_calibrate_write_speed(RA8875_context_t* ctx, int maxSpeed) {
+    int good = ctx->write_speed;
+
+    //Raise the clock by half each step until a write fails or we hit the limit
+    while (good < maxSpeed) {
+        int next = good + good / 2;
+        if (next > maxSpeed)
+            next = maxSpeed;
+
+        if (RA8875_set_write_speed(ctx, next) != ESP_OK || !write_pattern_ok(ctx))
+            break;
+        good = next;
+    }
+
+    //Back off even when nothing failed: maxSpeed passing one pattern on one board at one temperature is no more proof than any other step
+    int speed = good * RA8875_CALIBRATION_MARGIN_PCT / 100;
+    if (speed < ctx->read_speed)
+        speed = ctx->read_speed;
+    RA8875_set_write_speed(ctx, speed);
+    RA8875_invalidate_shadow(ctx);
+    return ctx->write_speed;
+}
+
+static void apply_configuration(RA8875_context_t* ctx) {
+    const RA8875_config_t* c = &ctx->config;
     //Turn display on
     RA8875_write_register(ctx, RA8875_PWRR, RA8875_PWRR_NORMAL | RA8875_PWRR_DISPON);
 
@@ -83,38 +213,81 @@ void RA8875_configure(RA8875_context_t* ctx, uint8_t hsync_nondisp, uint8_t hsyn
     RA8875_write_register(ctx, 0x20, 1 << 7);
 
     //Horizontal settings registers
-    RA8875_write_register(ctx, RA8875_HDWR, (width / 8) - 1); // H width: (HDWR + 1) * 8 = 480
-    RA8875_write_register(ctx, RA8875_HNDFTR, RA8875_HNDFTR_DE_HIGH + hsync_finetune);
-    RA8875_write_register(ctx, RA8875_HNDR, (hsync_nondisp - hsync_finetune - 2) / 8); // H non-display: HNDR * 8 + HNDFTR + 2 = 10
-    RA8875_write_register(ctx, RA8875_HSTR, hsync_start / 8 - 1); // Hsync start: (HSTR + 1)*8
-    RA8875_write_register(ctx, RA8875_HPWR, RA8875_HPWR_LOW + (hsync_pw / 8 - 1)); // HSync pulse width = (HPWR+1) * 8
+    RA8875_write_register(ctx, RA8875_HDWR, (c->width / 8) - 1); // H c->width: (HDWR + 1) * 8 = 480
+    RA8875_write_register(ctx, RA8875_HNDFTR, RA8875_HNDFTR_DE_HIGH + c->hsync_finetune);
+    RA8875_write_register(ctx, RA8875_HNDR, (c->hsync_nondisp - c->hsync_finetune - 2) / 8); // H non-display: HNDR * 8 + HNDFTR + 2 = 10
+    RA8875_write_register(ctx, RA8875_HSTR, c->hsync_start / 8 - 1); // Hsync start: (HSTR + 1)*8
+    RA8875_write_register(ctx, RA8875_HPWR, RA8875_HPWR_LOW + (c->hsync_pw / 8 - 1)); // HSync pulse c->width = (HPWR+1) * 8
 
     //Vertical settings registers
-    RA8875_write_register(ctx, RA8875_VDHR0, (uint16_t)(height - 1 + voffset) & 0xFF);
-    RA8875_write_register(ctx, RA8875_VDHR1, (uint16_t)(height - 1 + voffset) >> 8);
-    RA8875_write_register(ctx, RA8875_VNDR0, vsync_nondisp - 1); // V non-display period = VNDR + 1
-    RA8875_write_register(ctx, RA8875_VNDR1, vsync_nondisp >> 8);
-    RA8875_write_register(ctx, RA8875_VSTR0, vsync_start - 1); // Vsync start position = VSTR + 1
-    RA8875_write_register(ctx, RA8875_VSTR1, vsync_start >> 8);
-    RA8875_write_register(ctx, RA8875_VPWR, RA8875_VPWR_LOW + vsync_pw - 1); // Vsync pulse width = VPWR + 1
+    RA8875_write_register(ctx, RA8875_VDHR0, (uint16_t)(c->height - 1 + c->voffset) & 0xFF);
+    RA8875_write_register(ctx, RA8875_VDHR1, (uint16_t)(c->height - 1 + c->voffset) >> 8);
+    RA8875_write_register(ctx, RA8875_VNDR0, c->vsync_nondisp - 1); // V non-display period = VNDR + 1
+    RA8875_write_register(ctx, RA8875_VNDR1, c->vsync_nondisp >> 8);
+    RA8875_write_register(ctx, RA8875_VSTR0, c->vsync_start - 1); // Vsync start position = VSTR + 1
+    RA8875_write_register(ctx, RA8875_VSTR1, c->vsync_start >> 8);
+    RA8875_write_register(ctx, RA8875_VPWR, RA8875_VPWR_LOW + c->vsync_pw - 1); // Vsync pulse c->width = VPWR + 1
 
     /* Set active window X */
     RA8875_write_register(ctx, RA8875_HSAW0, 0); // horizontal start point
     RA8875_write_register(ctx, RA8875_HSAW1, 0);
-    RA8875_write_register(ctx, RA8875_HEAW0, (uint16_t)(width - 1) & 0xFF); // horizontal end point
-    RA8875_write_register(ctx, RA8875_HEAW1, (uint16_t)(width - 1) >> 8);
+    RA8875_write_register(ctx, RA8875_HEAW0, (uint16_t)(c->width - 1) & 0xFF); // horizontal end point
+    RA8875_write_register(ctx, RA8875_HEAW1, (uint16_t)(c->width - 1) >> 8);
 
     /* Set active window Y */
-    RA8875_write_register(ctx, RA8875_VSAW0, 0 + voffset); // vertical start point
-    RA8875_write_register(ctx, RA8875_VSAW1, 0 + voffset);
-    RA8875_write_register(ctx, RA8875_VEAW0, (uint16_t)(height - 1 + voffset) & 0xFF); // vertical end point
-    RA8875_write_register(ctx, RA8875_VEAW1, (uint16_t)(height - 1 + voffset) >> 8);
+    RA8875_write_register(ctx, RA8875_VSAW0, 0 + c->voffset); // vertical start point
+    RA8875_write_register(ctx, RA8875_VSAW1, 0 + c->voffset);
+    RA8875_write_register(ctx, RA8875_VEAW0, (uint16_t)(c->height - 1 + c->voffset) & 0xFF); // vertical end point
+    RA8875_write_register(ctx, RA8875_VEAW1, (uint16_t)(c->height - 1 + c->voffset) >> 8);
+}
+
+void RA8875_configure(RA8875_context_t* ctx, uint8_t hsync_nondisp, uint8_t hsync_start, uint8_t hsync_pw, uint8_t hsync_finetune, uint16_t vsync_nondisp, uint16_t vsync_start, uint8_t vsync_pw, uint16_t width, uint16_t height, uint16_t voffset) {
+    ctx->config = (RA8875_config_t){
+        .hsync_nondisp = hsync_nondisp, .hsync_start = hsync_start, .hsync_pw = hsync_pw, .hsync_finetune = hsync_finetune,
+        .vsync_nondisp = vsync_nondisp, .vsync_start = vsync_start, .vsync_pw = vsync_pw,
+        .width = width, .height = height, .voffset = voffset,
+    };
+    ctx->configured = 1;
+    apply_configuration(ctx);
+}
+
+esp_err_t RA8875_recover(RA8875_context_t* ctx) {
+    //Let whatever is still queued go out, then step the write clock down
+    RA8875_flush(ctx);
+    ctx->pending = 0;
+    ctx->bte_callback = NULL;
+    ctx->bte_completed = ctx->bte_started;
+    int speed = ctx->write_speed * RA8875_CALIBRATION_MARGIN_PCT / 100;
+    if (speed < ctx->read_speed)
+        speed = ctx->read_speed;
+    RA8875_set_write_speed(ctx, speed);
+
+    //Nothing the shadow says can be trusted now, so write everything again
+    RA8875_invalidate_shadow(ctx);
+    ctx->error = ESP_OK;
+    if (ctx->configured)
+        apply_configuration(ctx);
+    enable_interrupts(ctx);
+    return RA8875_verify(ctx);
 }
 
 void RA8875_clear(RA8875_context_t* ctx) {
     RA8875_write_register(ctx, RA8875_MCLR, RA8875_MCLR_START | RA8875_MCLR_FULL);
 }
 
+void RA8875_clear_region(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t layer, uint8_t color) {
+    //Memory clear fills the active window of the writing layer with the background color
+    RA8875_set_active_window(ctx, x1, y1, x2, y2);
+    RA8875_set_writing_layer(ctx, layer);
+    RA8875_write_register(ctx, 0x60, (color >> 0) & 0b111);
+    RA8875_write_register(ctx, 0x61, (color >> 3) & 0b111);
+    RA8875_write_register(ctx, 0x62, (color >> 6) & 0b11);
+    RA8875_write_register(ctx, RA8875_MCLR, RA8875_MCLR_START | RA8875_MCLR_ACTIVE);
+
+    //This waits for the clear, since the window can't change under it
+    RA8875_reset_active_window(ctx);
+}
+
 void RA8875_set_backlight_brightness(RA8875_context_t* ctx, uint8_t brightness) {
     RA8875_write_register(ctx, RA8875_P1DCR, brightness);
 }
\ No newline at end of file
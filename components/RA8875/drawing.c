@@ -6,22 +6,102 @@ static void set_double_register(RA8875_context_t* ctx, uint8_t reg, uint16_t val
     RA8875_write_register(ctx, reg + 1, value >> 8);
 }
 
-void RA8875_draw_rect(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color, uint8_t filled) {
-    //Set up
+static void set_color(RA8875_context_t* ctx, uint8_t color) {
+    //Set colors (in 256-color mode, we set only the lowest 3:3:2 bits)
+    RA8875_write_register(ctx, 0x63, (color >> 0) & 0b111);
+    RA8875_write_register(ctx, 0x64, (color >> 3) & 0b111);
+    RA8875_write_register(ctx, 0x65, (color >> 6) & 0b11);
+}
+
+// Start and end points, shared by lines, triangles, rectangles, and rounded rectangles
+static void set_line_points(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
     set_double_register(ctx, 0x91, x1);
     set_double_register(ctx, 0x93, y1);
     set_double_register(ctx, 0x95, x2);
     set_double_register(ctx, 0x97, y2);
+}
 
-    //Set colors (in 256-color mode, we set only the lowest 3:3:2 bits)
-    RA8875_write_register(ctx, 0x63, (color >> 0) & 0b111);
-    RA8875_write_register(ctx, 0x64, (color >> 3) & 0b111);
-    RA8875_write_register(ctx, 0x65, (color >> 6) & 0b11);
+// Center and axes, shared by ellipses and curves. Rounded rectangles use the axes as their corner radii.
+static void set_ellipse_axes(RA8875_context_t* ctx, uint16_t longAxis, uint16_t shortAxis) {
+    set_double_register(ctx, 0xA1, longAxis);
+    set_double_register(ctx, 0xA3, shortAxis);
+}
+
+static void set_ellipse_center(RA8875_context_t* ctx, uint16_t x, uint16_t y) {
+    set_double_register(ctx, 0xA5, x);
+    set_double_register(ctx, 0xA7, y);
+}
+
+void RA8875_draw_rect(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color, uint8_t filled) {
+    //Set up
+    set_line_points(ctx, x1, y1, x2, y2);
+    set_color(ctx, color);
 
     //Execute
     RA8875_write_register(ctx, RA8875_DCR, filled ? 0xB0 : 0x90);
 }
 
+void RA8875_draw_line(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color) {
+    //Set up
+    set_line_points(ctx, x1, y1, x2, y2);
+    set_color(ctx, color);
+
+    //Execute
+    RA8875_write_register(ctx, RA8875_DCR, RA8875_DCR_LINESQUTRI_START | RA8875_DCR_DRAWLINE);
+}
+
+void RA8875_draw_triangle(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint8_t color, uint8_t filled) {
+    //Set up, the third point has its own registers
+    set_line_points(ctx, x1, y1, x2, y2);
+    set_double_register(ctx, 0xA9, x3);
+    set_double_register(ctx, 0xAB, y3);
+    set_color(ctx, color);
+
+    //Execute
+    RA8875_write_register(ctx, RA8875_DCR, RA8875_DCR_LINESQUTRI_START | RA8875_DCR_DRAWTRIANGLE | (filled ? RA8875_DCR_FILL : RA8875_DCR_NOFILL));
+}
+
+void RA8875_draw_circle(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t radius, uint8_t color, uint8_t filled) {
+    //Set up
+    set_double_register(ctx, 0x99, x);
+    set_double_register(ctx, 0x9B, y);
+    RA8875_write_register(ctx, 0x9D, radius);
+    set_color(ctx, color);
+
+    //Execute
+    RA8875_write_register(ctx, RA8875_DCR, RA8875_DCR_CIRCLE_START | (filled ? RA8875_DCR_FILL : RA8875_DCR_NOFILL));
+}
+
+void RA8875_draw_ellipse(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint16_t longAxis, uint16_t shortAxis, uint8_t color, uint8_t filled) {
+    //Set up
+    set_ellipse_center(ctx, x, y);
+    set_ellipse_axes(ctx, longAxis, shortAxis);
+    set_color(ctx, color);
+
+    //Execute
+    RA8875_write_register(ctx, RA8875_ELLIPSE, filled ? 0xC0 : 0x80);
+}
+
+void RA8875_draw_curve(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint16_t longAxis, uint16_t shortAxis, uint8_t part, uint8_t color, uint8_t filled) {
+    //Set up
+    set_ellipse_center(ctx, x, y);
+    set_ellipse_axes(ctx, longAxis, shortAxis);
+    set_color(ctx, color);
+
+    //Execute, bit 4 selects a curve and the low two bits the quarter
+    RA8875_write_register(ctx, RA8875_ELLIPSE, (filled ? 0xD0 : 0x90) | (part & 0b11));
+}
+
+void RA8875_draw_round_rect(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t radius, uint8_t color, uint8_t filled) {
+    //Set up
+    set_line_points(ctx, x1, y1, x2, y2);
+    set_ellipse_axes(ctx, radius, radius);
+    set_color(ctx, color);
+
+    //Execute, bit 5 selects a rounded rectangle
+    RA8875_write_register(ctx, RA8875_ELLIPSE, filled ? 0xE0 : 0xA0);
+}
+
 // ADDED BY WISCONSIN RACING
 void RA8875_draw_rect_fast(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
     //Set up
@@ -41,5 +121,29 @@ void RA8875_draw_data(RA8875_context_t* ctx, uint16_t x, uint16_t y, const uint8
 
     //Send payload
     RA8875_write_command(ctx, RA8875_MRWC);
-    RA8875_write_data_block(ctx, buffer, len);
+    RA8875_write_data_stream(ctx, buffer, len);
+}
+
+void RA8875_blit_begin(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height) {
+    //The write cursor wraps to the next row at the window's right edge, so the image can go out as one stream
+    RA8875_set_active_window(ctx, x, y, x + width - 1, y + height - 1);
+    RA8875_write_register(ctx, RA8875_MWCR0, RA8875_MWCR0_GFXMODE);
+    RA8875_set_writing_layer(ctx, layer);
+    set_double_register(ctx, RA8875_CURH0, x);
+    set_double_register(ctx, RA8875_CURV0, y);
+    RA8875_write_command(ctx, RA8875_MRWC);
+}
+
+void RA8875_blit_end(RA8875_context_t* ctx) {
+    RA8875_reset_active_window(ctx);
+}
+
+esp_err_t RA8875_blit(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, const uint8_t* data) {
+    if (!width || !height)
+        return ESP_OK;
+
+    RA8875_blit_begin(ctx, x, y, layer, width, height);
+    esp_err_t ret = RA8875_write_data_stream(ctx, data, (int)width * (int)height);
+    RA8875_blit_end(ctx);
+    return ret;
 }
\ No newline at end of file
@@ -15,10 +15,50 @@ void RA8875_set_read_cursor_position(RA8875_context_t* ctx, uint16_t x, uint16_t
     RA8875_write_register(ctx, RA8875_RCURV1, y >> 8);
 }
 
+void RA8875_set_active_window(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+    RA8875_write_register(ctx, RA8875_HSAW0, x1);
+    RA8875_write_register(ctx, RA8875_HSAW1, x1 >> 8);
+    RA8875_write_register(ctx, RA8875_VSAW0, y1);
+    RA8875_write_register(ctx, RA8875_VSAW1, y1 >> 8);
+    RA8875_write_register(ctx, RA8875_HEAW0, x2);
+    RA8875_write_register(ctx, RA8875_HEAW1, x2 >> 8);
+    RA8875_write_register(ctx, RA8875_VEAW0, y2);
+    RA8875_write_register(ctx, RA8875_VEAW1, y2 >> 8);
+}
+
+void RA8875_reset_active_window(RA8875_context_t* ctx) {
+    const RA8875_config_t* c = &ctx->config;
+    RA8875_set_active_window(ctx, 0, c->voffset, c->width - 1, c->height - 1 + c->voffset);
+}
+
 void RA8875_set_layer_transparency(RA8875_context_t* ctx, uint8_t scrollMode, uint8_t floatingWindowsEnable, uint8_t displayMode) {
     RA8875_write_register(ctx, 0x52, displayMode | (floatingWindowsEnable << 5) | (scrollMode << 6));
 }
 
+void RA8875_set_transparent_color(RA8875_context_t* ctx, uint8_t color) {
+    RA8875_write_register(ctx, 0x67, (color >> 0) & 0b111);
+    RA8875_write_register(ctx, 0x68, (color >> 3) & 0b111);
+    RA8875_write_register(ctx, 0x69, (color >> 6) & 0b11);
+}
+
+void RA8875_set_layer_mix(RA8875_context_t* ctx, uint8_t layer1Level, uint8_t layer2Level) {
+    RA8875_write_register(ctx, 0x53, (layer1Level & 0xF) | ((layer2Level & 0xF) << 4));
+}
+
 void RA8875_set_writing_layer(RA8875_context_t* ctx, uint8_t layer) {
     RA8875_write_register(ctx, 0x41, layer & 1);
+}
+
+void RA8875_write_cgram(RA8875_context_t* ctx, uint8_t index, const uint8_t* bitmap) {
+    //CGRAM is only writable in graphic mode
+    RA8875_write_register(ctx, RA8875_MWCR0, RA8875_MWCR0_GFXMODE);
+    RA8875_write_register(ctx, RA8875_MWCR1, RA8875_MWCR1_DEST_CGRAM);
+    RA8875_write_register(ctx, RA8875_CGSR, index);
+
+    //Send payload
+    RA8875_write_command(ctx, RA8875_MRWC);
+    RA8875_write_data_block(ctx, bitmap, 16);
+
+    //Point memory writes back at the display
+    RA8875_write_register(ctx, RA8875_MWCR1, RA8875_MWCR1_DEST_LAYER);
 }
\ No newline at end of file
@@ -0,0 +1,247 @@
+/**
+* Host test: queued writes reach the wire in the order they were issued.
+*
+*     gcc -Wall -Icomponents/RA8875/host_test/stubs components/RA8875/host_test/io_order_test.c components/RA8875/io.c -o io_order_test && ./io_order_test
+*
+* The fake driver only puts a queued transaction on the wire when it's reclaimed, the latest the real one could send it,
+* so a read or a reused descriptor that jumps the queue shows up as bytes out of order.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../include/RA8875.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_memory_utils.h"
+
+struct spi_device_t { int unused; };
+static struct spi_device_t readDevice, writeDevice;
+
+static uint8_t wire[4096], expected[4096];
+static size_t wireLen, expectedLen;
+
+static spi_transaction_t* queued[RA8875_QUEUE_DEPTH];
+static spi_transaction_t queuedCopy[RA8875_QUEUE_DEPTH];
+static size_t queuedHead, queuedCount;
+
+static uint8_t readValue;
+static esp_err_t failNext;  // Returned by the next transaction the fake driver handles
+static int failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("  %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static void Wire_Send(const spi_transaction_t* t)
+{
+    const uint8_t* bytes = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : t->tx_buffer;
+    wire[wireLen++] = (uint8_t)t->cmd;
+    for (size_t i = 0; i < t->length / 8; ++i) wire[wireLen++] = bytes[i];
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t* trans, TickType_t ticks_to_wait)
+{
+    CHECK(handle == &writeDevice);
+    if (failNext) {
+        esp_err_t err = failNext;
+        failNext = ESP_OK;
+        return err;
+    }
+    CHECK(queuedCount < RA8875_QUEUE_DEPTH);  // The real driver would block forever: nobody reclaims while we wait
+    for (size_t i = 0; i < queuedCount; ++i) {
+        CHECK(queued[(queuedHead + i) % RA8875_QUEUE_DEPTH] != trans);  // Descriptor reused while still in flight
+    }
+
+    size_t slot = (queuedHead + queuedCount++) % RA8875_QUEUE_DEPTH;
+    queued[slot] = trans;
+    queuedCopy[slot] = *trans;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t** trans, TickType_t ticks_to_wait)
+{
+    CHECK(handle == &writeDevice);
+    CHECK(queuedCount > 0);
+    if (!queuedCount) return ESP_FAIL;
+
+    spi_transaction_t* t = queued[queuedHead];
+    CHECK(memcmp(t, &queuedCopy[queuedHead], sizeof(*t)) == 0);  // Descriptor changed before the driver was done with it
+    queuedHead = (queuedHead + 1) % RA8875_QUEUE_DEPTH;
+    queuedCount--;
+    *trans = t;
+
+    esp_err_t err = failNext;
+    failNext = ESP_OK;
+    if (err == ESP_OK) Wire_Send(t);
+    return err;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t* trans)
+{
+    Wire_Send(trans);
+    if (trans->flags & SPI_TRANS_USE_RXDATA) trans->rx_data[trans->length / 8 - 1] = readValue;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, TickType_t wait) { return ESP_OK; }
+void spi_device_release_bus(spi_device_handle_t dev) {}
+bool esp_ptr_dma_capable(const void* p) { return true; }
+int64_t esp_timer_get_time(void) { return 0; }
+void vTaskSetTimeOutState(TimeOut_t* timeout) {}
+BaseType_t xTaskCheckForTimeOut(TimeOut_t* timeout, TickType_t* remaining) { return 1; }
+esp_err_t RA8875_bte_wait(RA8875_context_t* ctx, RA8875_bte_handle_t handle) { return ESP_OK; }
+
+static void ExpectRegister(uint8_t reg, uint8_t value)
+{
+    const uint8_t bytes[] = { 0x80, reg, 0x00, value };
+    memcpy(&expected[expectedLen], bytes, sizeof(bytes));
+    expectedLen += sizeof(bytes);
+}
+
+static void ExpectCommand(uint8_t reg)
+{
+    expected[expectedLen++] = 0x80;
+    expected[expectedLen++] = reg;
+}
+
+static void ExpectData(uint8_t value)
+{
+    expected[expectedLen++] = 0x00;
+    expected[expectedLen++] = value;
+}
+
+static void ExpectRead(uint8_t reg)
+{
+    ExpectRegister(reg, 0);
+    expected[expectedLen - 2] = 0x40;
+}
+
+static void CheckWire(void)
+{
+    CHECK(wireLen == expectedLen);
+    CHECK(memcmp(wire, expected, expectedLen) == 0);
+}
+
+static void Setup(RA8875_context_t* ctx)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->spi_device = &readDevice;
+    ctx->spi_write_device = &writeDevice;
+    RA8875_set_async(ctx, 1);
+    wireLen = expectedLen = 0;
+    queuedHead = queuedCount = 0;
+    failNext = ESP_OK;
+}
+
+// Several times around the ring, with commands and data mixed in between register writes
+static void Test_RingWrap(void)
+{
+    RA8875_context_t ctx;
+    Setup(&ctx);
+
+    for (int i = 0; i < 3 * RA8875_QUEUE_DEPTH + 5; ++i) {
+        uint8_t reg = (i & 1) ? 0x58 : 0x54;  // Every value differs from the last one written there, so the shadow skips nothing
+        RA8875_write_register(&ctx, reg, (uint8_t)i);
+        ExpectRegister(reg, (uint8_t)i);
+        if (i % 5 == 0) {
+            RA8875_write_command(&ctx, 0x02);
+            RA8875_write_data(&ctx, (uint8_t)~i);
+            ExpectCommand(0x02);
+            ExpectData((uint8_t)~i);
+        }
+    }
+    CHECK(ctx.queue_pending == RA8875_QUEUE_DEPTH);  // Writes were queued, not sent one at a time
+
+    CHECK(RA8875_flush(&ctx) == ESP_OK);
+    CHECK(ctx.queue_pending == 0 && queuedCount == 0);
+    CheckWire();
+}
+
+// Everything issued before a flush is on the wire when it returns, and nothing after it is sent early
+static void Test_Flush(void)
+{
+    RA8875_context_t ctx;
+    Setup(&ctx);
+
+    RA8875_write_register(&ctx, 0x54, 1);
+    RA8875_write_command(&ctx, 0x02);
+    RA8875_write_data(&ctx, 2);
+    ExpectRegister(0x54, 1);
+    ExpectCommand(0x02);
+    ExpectData(2);
+    RA8875_flush(&ctx);
+    CheckWire();
+
+    RA8875_write_register(&ctx, 0x54, 3);
+    CHECK(wireLen == expectedLen);
+    ExpectRegister(0x54, 3);
+    RA8875_flush(&ctx);
+    CheckWire();
+}
+
+// A read goes out on the other device, after every write issued before it and before every write issued after it
+static void Test_InterleavedRead(void)
+{
+    RA8875_context_t ctx;
+    Setup(&ctx);
+
+    for (int i = 0; i < RA8875_QUEUE_DEPTH - 1; ++i) {
+        RA8875_write_register(&ctx, 0x54, (uint8_t)i);
+        ExpectRegister(0x54, (uint8_t)i);
+    }
+
+    readValue = 0x5A;
+    CHECK(RA8875_read_register(&ctx, 0x40) == 0x5A);
+    ExpectRead(0x40);
+
+    RA8875_write_register(&ctx, 0x40, 0x5A);  // Matches what the read saw, so the shadow skips it
+    RA8875_write_register(&ctx, 0x40, 0x5B);
+    RA8875_write_command(&ctx, 0x02);
+    ExpectRegister(0x40, 0x5B);
+    ExpectCommand(0x02);
+    RA8875_flush(&ctx);
+    CheckWire();
+}
+
+// A write the driver failed isn't taken as done, so writing the same value again goes out
+static void Test_FailedWrite(void)
+{
+    RA8875_context_t ctx;
+    Setup(&ctx);
+
+    failNext = ESP_FAIL;
+    CHECK(RA8875_write_register(&ctx, 0x54, 7) == ESP_FAIL);
+    RA8875_write_register(&ctx, 0x54, 7);
+    ExpectRegister(0x54, 7);
+    RA8875_flush(&ctx);
+    CheckWire();
+
+    //Queued writes only report failing when they're reclaimed, after the shadow already took them
+    RA8875_write_register(&ctx, 0x58, 1);
+    RA8875_write_register(&ctx, 0x54, 8);
+    failNext = ESP_FAIL;
+    CHECK(RA8875_flush(&ctx) == ESP_FAIL);
+    RA8875_write_register(&ctx, 0x58, 1);
+    RA8875_write_register(&ctx, 0x54, 8);
+    ExpectRegister(0x54, 8);
+    ExpectRegister(0x58, 1);
+    ExpectRegister(0x54, 8);
+    RA8875_flush(&ctx);
+    CheckWire();
+    CHECK(RA8875_take_error(&ctx) == ESP_FAIL);
+}
+
+int main(void)
+{
+    static const struct { const char* name; void (*run)(void); } tests[] = {
+        { "ring wrap", Test_RingWrap },
+        { "flush", Test_Flush },
+        { "interleaved read", Test_InterleavedRead },
+        { "failed write", Test_FailedWrite },
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        int before = failures;
+        tests[i].run();
+        printf("%-18s %s\n", tests[i].name, failures == before ? "ok" : "FAIL");
+    }
+    return failures ? 1 : 0;
+}
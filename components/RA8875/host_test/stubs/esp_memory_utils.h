@@ -0,0 +1,5 @@
+// Host stand-in for the ESP-IDF header, just enough for io.c
+#pragma once
+#include <stdbool.h>
+
+bool esp_ptr_dma_capable(const void* p);
@@ -0,0 +1,5 @@
+// Host stand-in for the ESP-IDF header, just enough for io.c
+#pragma once
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,5 @@
+// Host stand-in for the ESP-IDF header, just enough for io.c
+#pragma once
+#include "FreeRTOS.h"
+
+typedef void* SemaphoreHandle_t;
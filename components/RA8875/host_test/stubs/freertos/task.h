@@ -0,0 +1,7 @@
+// Host stand-in for the ESP-IDF header, just enough for io.c
+#pragma once
+#include "FreeRTOS.h"
+
+typedef struct { TickType_t start; } TimeOut_t;
+void vTaskSetTimeOutState(TimeOut_t* timeout);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t* timeout, TickType_t* remaining);
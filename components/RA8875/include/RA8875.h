@@ -2,11 +2,104 @@
 
 #include <stdint.h>
 #include "driver/spi_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
+// Number of preallocated transaction descriptors used for queued (async) writes. Also used as the SPI device queue size.
+#define RA8875_QUEUE_DEPTH 16
+
+// Engines that run on their own after being started. A write issued while one is pending waits for it first, see RA8875_wait_idle.
+#define RA8875_PENDING_DRAW    (1 << 0) // Line, rectangle, triangle, circle (DCR)
+#define RA8875_PENDING_ELLIPSE (1 << 1) // Ellipse, curve, rounded rectangle (ELLIPSE)
+#define RA8875_PENDING_CLEAR   (1 << 2) // Memory clear (MCLR)
+#define RA8875_PENDING_BTE     (1 << 3) // Block transfer started by an RA8875_bte_*_async call
+
+// Largest single SPI transaction, the bus's max_transfer_sz
+#define RA8875_MAX_TRANSFER 8000
+
+// Size of each of the two DMA-capable bounce buffers RA8875_write_data_stream copies through
+#define RA8875_STREAM_CHUNK 4000
+
+// How long RA8875_wait_idle waits for an engine before giving up with ESP_ERR_TIMEOUT
+#define RA8875_IDLE_TIMEOUT_MS 100
+
+// Fraction of the fastest passing write clock that RA8875_calibrate_write_speed settles on
+#define RA8875_CALIBRATION_MARGIN_PCT 75
+
+// 1 compiles in the low-level fast path for small writes, see RA8875_set_fast_path. Off by default; compare with RA8875_benchmark_register_writes first.
+#ifndef RA8875_LL_FAST_PATH
+#define RA8875_LL_FAST_PATH 0
+#endif
+
+// How long BTE operations wait for the INT pin before giving up with ESP_ERR_TIMEOUT. A full-screen move takes a few ms.
+#define RA8875_BTE_TIMEOUT_MS 100
+
+// Layer display modes for RA8875_set_layer_transparency (LTPR0 bits 2:0)
+#define RA8875_LAYER_SHOW_1       0 // Only layer 1
+#define RA8875_LAYER_SHOW_2       1 // Only layer 2
+#define RA8875_LAYER_LIGHTEN      2 // Both, mixed by the levels of RA8875_set_layer_mix
+#define RA8875_LAYER_TRANSPARENT  3 // Layer 1, with layer 2 showing through where layer 1 has the BGTR color
+#define RA8875_LAYER_FLOATING     6 // Floating window
+
+// Arguments of the last RA8875_configure, kept so RA8875_recover can apply them again
 typedef struct {
+    uint8_t hsync_nondisp, hsync_start, hsync_pw, hsync_finetune;
+    uint16_t vsync_nondisp, vsync_start;
+    uint8_t vsync_pw;
+    uint16_t width, height, voffset;
+} RA8875_config_t;
+
+// Identifies an async BTE operation for RA8875_bte_wait
+typedef uint32_t RA8875_bte_handle_t;
 
-    spi_device_handle_t spi_device;
+// Called once when an async BTE operation finishes. Runs in the INT pin interrupt, so keep it short (give a semaphore, notify a task) and in IRAM.
+typedef void (*RA8875_bte_callback_t)(void* arg);
+
+typedef struct {
+
+    spi_device_handle_t spi_device;       // Init clock, used for reads
+    spi_device_handle_t spi_write_device; // Write clock, see RA8875_set_write_speed
+    int host;
+    int pin_cs;                           // Driven by hand, since both devices share it
     int pin_int;
+    int read_speed;
+    int write_speed;
+    SemaphoreHandle_t int_sem; // Given by the INT pin ISR, NULL if the ISR couldn't be installed
+
+    // Queued write ring, see RA8875_set_async
+    uint8_t async;
+    uint8_t queue_head;
+    uint8_t queue_pending;
+    spi_transaction_t queue[RA8875_QUEUE_DEPTH];
+
+    // Double buffer for RA8875_write_data_stream, buffers NULL if they couldn't be allocated
+    uint8_t* stream_buf[2];
+    spi_transaction_t stream_trans[2];
+
+    // Write-through shadow of the register file, see RA8875_write_register
+    uint8_t shadow[256];
+    uint8_t shadow_valid[256 / 8];
+    uint32_t suppressed_writes;
+    uint32_t bytes_written; // Command and data bytes sent, see RA8875_get_bytes_written
+
+    // Low-level fast path, see RA8875_set_fast_path
+    uint8_t fast_path;
+    uint8_t bus_acquired; // The write device holds the bus between fast writes, until the next read or flush
+
+    // RA8875_PENDING_* engines started but not yet seen idle
+    uint8_t pending;
+
+    // Async BTE bookkeeping. At most one BTE runs at a time, since any write waits for it first.
+    RA8875_bte_handle_t bte_started;
+    RA8875_bte_handle_t bte_completed;
+    RA8875_bte_callback_t volatile bte_callback; // Cleared by whoever calls it
+    void* bte_callback_arg;
+
+    // First error since the last RA8875_take_error, ESP_OK if none
+    esp_err_t error;
+
+    RA8875_config_t config;
+    uint8_t configured;
 
 } RA8875_context_t;
 
@@ -18,16 +111,58 @@ typedef struct {
 /// </summary>
 int RA8875_init(RA8875_context_t* ctx, int host, int speed, int pinMosi, int pinMiso, int pinSclk, int pinCs, int pinInt);
 
+/// <summary>
+/// Changes the SPI clock used for writes. Reads always stay at the speed passed to RA8875_init, since the RA8875 can't be read as fast as it can be written.
+/// </summary>
+esp_err_t RA8875_set_write_speed(RA8875_context_t* ctx, int speed);
+
+/// <summary>
+/// Raises the write clock step by step up to maxSpeed, checking each step by writing a pattern to scratch registers and reading it back at the read clock.
+/// It stops at the first failure and settles on RA8875_CALIBRATION_MARGIN_PCT of the fastest passing speed, maxSpeed included. Returns the write speed in use.
+/// Call after RA8875_configure, since the RA8875 only accepts fast writes once its PLL is running. A failed probe can garble another register, so the shadow is invalidated and RA8875_configure should be called again afterwards.
+/// </summary>
+int RA8875_calibrate_write_speed(RA8875_context_t* ctx, int maxSpeed);
+
 /// <summary>
 /// Sets up the display. This is a required command during initialization.
 /// </summary>
 void RA8875_configure(RA8875_context_t* ctx, uint8_t hsync_nondisp, uint8_t hsync_start, uint8_t hsync_pw, uint8_t hsync_finetune, uint16_t vsync_nondisp, uint16_t vsync_start, uint8_t vsync_pw, uint16_t width, uint16_t height, uint16_t voffset);
 
+/// <summary>
+/// Returns the first error any driver call hit since the last call to this, and clears it. SPI failures, engine and BTE timeouts, and RA8875_verify mismatches are all recorded here, so callers can check once per frame instead of after every write.
+/// </summary>
+esp_err_t RA8875_take_error(RA8875_context_t* ctx);
+
+/// <summary>
+/// Reads back a set of sentinel registers (display setup, colors, write mode, font, BTE coordinates) and compares them with what the driver last wrote.
+/// Returns ESP_ERR_INVALID_RESPONSE on the first mismatch, which means writes are being lost or garbled.
+/// </summary>
+esp_err_t RA8875_verify(RA8875_context_t* ctx);
+
+/// <summary>
+/// Recovers from lost or garbled writes: steps the write clock down by RA8875_CALIBRATION_MARGIN_PCT, forgets the shadow, and applies the last RA8875_configure again.
+/// Layer memory, CGRAM, and backlight brightness aren't restored, so redraw afterwards. Returns the result of RA8875_verify at the new clock.
+/// </summary>
+esp_err_t RA8875_recover(RA8875_context_t* ctx);
+
 /// <summary>
 /// Clears the current active layer with black.
 /// </summary>
 void RA8875_clear(RA8875_context_t* ctx);
 
+/// <summary>
+/// Fills the rectangle x1,y1 - x2,y2 (inclusive) of a layer with color, using a memory clear limited to the active window.
+/// Leaves the writing layer set to layer and the background color set to color, and waits for the clear to finish before restoring the full-screen active window.
+/// RA8875_bte_fill does the same job without the wait; see BENCHMARK_CLEARS in display.c for which is faster.
+/// </summary>
+void RA8875_clear_region(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t layer, uint8_t color);
+
+/// <summary>
+/// Waits for the draw and clear engines to finish whatever they were started on. Returns ESP_ERR_TIMEOUT if one is still busy after RA8875_IDLE_TIMEOUT_MS.
+/// Every write already does this when an engine is pending, since a drawing can't be reconfigured while it's in progress; call it directly to fence before reading back or timing.
+/// </summary>
+esp_err_t RA8875_wait_idle(RA8875_context_t* ctx);
+
 /// <summary>
 /// Sets the backlight brightness on a scale of 0x00-0xFF, where 0xFF is the brightest.
 /// </summary>
@@ -35,20 +170,56 @@ void RA8875_set_backlight_brightness(RA8875_context_t* ctx, uint8_t brightness);
 
 /* REGISTERS */
 
+/// <summary>
+/// Enables or disables queued writes. When enabled, register, command, and data writes are queued to the SPI driver from a preallocated ring of descriptors and return without waiting for the bus.
+/// Writes always go out in the order they were issued. Reads, block writes, and RA8875_flush wait for the queue to drain first.
+/// </summary>
+void RA8875_set_async(RA8875_context_t* ctx, uint8_t enabled);
+
+/// <summary>
+/// Blocks until every queued write has been clocked out to the device, and gives the bus back if the fast path was holding it. Does nothing when queued writes are disabled.
+/// </summary>
+esp_err_t RA8875_flush(RA8875_context_t* ctx);
+
+/// <summary>
+/// Enables or disables the low-level fast path (only available with RA8875_LL_FAST_PATH). When enabled, register, command, and single data writes skip the SPI driver:
+/// the write device acquires the bus once, and each write is loaded straight into the SPI peripheral's data registers and sent while the caller spins.
+/// The bus is held until the next read, block write, or RA8875_flush. Returns ESP_ERR_NOT_SUPPORTED if the fast path wasn't compiled in.
+/// </summary>
+esp_err_t RA8875_set_fast_path(RA8875_context_t* ctx, uint8_t enabled);
+
+// Average cost of one RA8875_write_register, including the time on the wire
+typedef struct {
+    uint32_t driver_ns; // Through the SPI driver, queued or polling as RA8875_set_async left it
+    uint32_t fast_ns;   // Through the low-level fast path, 0 if it wasn't compiled in
+} RA8875_write_benchmark_t;
+
+/// <summary>
+/// Times count register writes through each path and returns the average per write. Writes the BTE source/destination X registers, which every BTE rewrites anyway.
+/// Leaves the fast path as it found it.
+/// </summary>
+RA8875_write_benchmark_t RA8875_benchmark_register_writes(RA8875_context_t* ctx, int count);
+
 /// <summary>
 /// Writes a command to the device.
 /// </summary>
-void RA8875_write_command(RA8875_context_t* ctx, uint8_t reg);
+esp_err_t RA8875_write_command(RA8875_context_t* ctx, uint8_t reg);
 
 /// <summary>
 /// Writes a single byte of data to the device.
 /// </summary>
-void RA8875_write_data(RA8875_context_t* ctx, uint8_t value);
+esp_err_t RA8875_write_data(RA8875_context_t* ctx, uint8_t value);
 
 /// <summary>
-/// Writes a large block of data to the device. There is an upper limit to size. Maximum is ~512 bytes.
+/// Writes a block of data to the device in one transaction. Maximum is RA8875_MAX_TRANSFER bytes; use RA8875_write_data_stream for more.
 /// </summary>
-void RA8875_write_data_block(RA8875_context_t* ctx, const uint8_t* buffer, int nbytes);
+esp_err_t RA8875_write_data_block(RA8875_context_t* ctx, const uint8_t* buffer, int nbytes);
+
+/// <summary>
+/// Writes any amount of data to the device, i.e. after a MRWC command. DMA-capable buffers go out directly in RA8875_MAX_TRANSFER chunks.
+/// Anything else (flash, PSRAM) is copied through two RA8875_STREAM_CHUNK bounce buffers, filling one while the other is on the wire. No chunk waits on the display.
+/// </summary>
+esp_err_t RA8875_write_data_stream(RA8875_context_t* ctx, const uint8_t* buffer, int nbytes);
 
 /// <summary>
 /// Requests a read from the device. Usually prefixed by a command.
@@ -57,8 +228,34 @@ uint8_t RA8875_read_data(RA8875_context_t* ctx);
 
 /// <summary>
 /// Writes a register, combining a write command and write data into one transaction for speed.
+/// Writes are mirrored into a shadow copy of the register file and skipped if the register already holds the value. Registers the controller changes on its own (cursors, status, start bits) are always written. A write the SPI driver reports as failed isn't mirrored, so retrying it goes out.
+/// </summary>
+esp_err_t RA8875_write_register(RA8875_context_t* ctx, uint8_t reg, uint8_t value);
+
+/// <summary>
+/// Returns how many register writes have been skipped by the shadow register cache since init or the last reset.
+/// </summary>
+uint32_t RA8875_get_suppressed_writes(RA8875_context_t* ctx);
+
+/// <summary>
+/// Resets the skipped register write counter.
 /// </summary>
-void RA8875_write_register(RA8875_context_t* ctx, uint8_t reg, uint8_t value);
+void RA8875_reset_suppressed_writes(RA8875_context_t* ctx);
+
+/// <summary>
+/// Returns how many bytes register, command and data writes have put on the wire since init or the last reset, command bytes included.
+/// </summary>
+uint32_t RA8875_get_bytes_written(RA8875_context_t* ctx);
+
+/// <summary>
+/// Resets the written byte counter.
+/// </summary>
+void RA8875_reset_bytes_written(RA8875_context_t* ctx);
+
+/// <summary>
+/// Forgets every shadowed register value, so the next write to each register always goes out. Use after anything may have changed registers behind the driver's back.
+/// </summary>
+void RA8875_invalidate_shadow(RA8875_context_t* ctx);
 
 /// <summary>
 /// Reads a register, combining a write command and read data into one transaction for speed.
@@ -72,11 +269,66 @@ uint8_t RA8875_read_register(RA8875_context_t* ctx, uint8_t reg);
 /// </summary>
 void RA8875_draw_rect(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color, uint8_t filled);
 
+/*
+
+    The shapes below run on the RA8875's draw engines and return as soon as they're started. The next write waits for
+    the engine, so they can be issued back to back; see RA8875_wait_idle. Coordinates are in pixels on the writing layer.
+
+*/
+
+/// <summary>
+/// Draws a one pixel wide line between two points.
+/// </summary>
+void RA8875_draw_line(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color);
+
+/// <summary>
+/// Draws a triangle between three points, optionally filling it in.
+/// </summary>
+void RA8875_draw_triangle(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint8_t color, uint8_t filled);
+
+/// <summary>
+/// Draws a circle around (x, y), optionally filling it in. The radius register is only 8 bits wide; use RA8875_draw_ellipse for anything bigger.
+/// </summary>
+void RA8875_draw_circle(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t radius, uint8_t color, uint8_t filled);
+
+/// <summary>
+/// Draws an ellipse around (x, y) with the given horizontal (long) and vertical (short) radii, optionally filling it in.
+/// </summary>
+void RA8875_draw_ellipse(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint16_t longAxis, uint16_t shortAxis, uint8_t color, uint8_t filled);
+
+/// <summary>
+/// Draws one quarter of an ellipse, i.e. for arcs and gauge outlines. part picks the quarter: 0 lower left, 1 upper left, 2 upper right, 3 lower right.
+/// Filling it in fills the quarter pie slice.
+/// </summary>
+void RA8875_draw_curve(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint16_t longAxis, uint16_t shortAxis, uint8_t part, uint8_t color, uint8_t filled);
+
+/// <summary>
+/// Draws a rectangle with corners rounded to radius, optionally filling it in. The radius has to be less than half the rectangle's width and height.
+/// </summary>
+void RA8875_draw_round_rect(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t radius, uint8_t color, uint8_t filled);
+
 /// <summary>
 /// ADDED BY WISCONSIN RACING. Draws rectangle without color set
 /// </summary>
 void RA8875_draw_rect_fast(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
 
+/// <summary>
+/// Draws a width x height image of 8-bit pixels, row by row, to a layer. The active window is set to the rectangle so the write cursor wraps at its edges,
+/// and the whole image is streamed through MRWC with RA8875_write_data_stream, with no BTE handshake. Restores the full-screen active window afterwards.
+/// </summary>
+esp_err_t RA8875_blit(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, const uint8_t* data);
+
+/// <summary>
+/// Starts a blit whose pixels are produced piece by piece: sets up the window, layer and cursor like RA8875_blit and issues MRWC.
+/// Send the width x height pixels in any number of RA8875_write_data_stream calls, with no other writes in between, then call RA8875_blit_end.
+/// </summary>
+void RA8875_blit_begin(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height);
+
+/// <summary>
+/// Finishes a blit started with RA8875_blit_begin by restoring the full-screen active window.
+/// </summary>
+void RA8875_blit_end(RA8875_context_t* ctx);
+
 /// <summary>
 /// Draws a data directly to the screen in a linear fashion, not in a rectangle. RA8875_bte_write is typically more useful.
 /// </summary>
@@ -94,16 +346,42 @@ void RA8875_set_write_cursor_position(RA8875_context_t* ctx, uint16_t x, uint16_
 /// </summary>
 void RA8875_set_read_cursor_position(RA8875_context_t* ctx, uint16_t x, uint16_t y);
 
+/// <summary>
+/// Sets the active window (pg 24). Memory writes wrap at its edges, and text and drawing are clipped to it.
+/// </summary>
+void RA8875_set_active_window(RA8875_context_t* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+
+/// <summary>
+/// Sets the active window back to the whole screen, as RA8875_configure left it.
+/// </summary>
+void RA8875_reset_active_window(RA8875_context_t* ctx);
+
 /// <summary>
 /// Sets the layer transparency register (pg 31)
 /// </summary>
 void RA8875_set_layer_transparency(RA8875_context_t* ctx, uint8_t scrollMode, uint8_t floatingWindowsEnable, uint8_t displayMode);
 
+/// <summary>
+/// Sets the color (8bpp 3:3:2) of layer 1 that RA8875_LAYER_TRANSPARENT mode shows layer 2 through (BGTR).
+/// </summary>
+void RA8875_set_transparent_color(RA8875_context_t* ctx, uint8_t color);
+
+/// <summary>
+/// Sets how much of each layer shows in RA8875_LAYER_LIGHTEN mode (LTPR1). Levels are eighths hidden: 0 shows the layer fully, 4 at half, 8 not at all.
+/// </summary>
+void RA8875_set_layer_mix(RA8875_context_t* ctx, uint8_t layer1Level, uint8_t layer2Level);
+
 /// <summary>
 /// Sets the memory write control register layer. This has the sideeffect of disabling the graphic cursor.
 /// </summary>
 void RA8875_set_writing_layer(RA8875_context_t* ctx, uint8_t layer);
 
+/// <summary>
+/// Uploads one 8x16 user-defined character (16 bytes, one per row, MSB is the leftmost pixel) into CGRAM slot index.
+/// Select CGRAM in FNCR0 to draw it in text mode. Leaves the controller in graphic mode, writing to layer 0.
+/// </summary>
+void RA8875_write_cgram(RA8875_context_t* ctx, uint8_t index, const uint8_t* bitmap);
+
 /* BTE */
 
 /*
@@ -131,18 +409,60 @@ void RA8875_set_writing_layer(RA8875_context_t* ctx, uint8_t layer);
 
 #define RA8875_ROP_SRC 0b1100
 
+/*
+
+    Every BTE call waits for the engine on the INT pin, blocking on an interrupt rather than spinning, and returns
+    ESP_ERR_TIMEOUT if the RA8875 doesn't signal within RA8875_BTE_TIMEOUT_MS.
+
+    Moves and fills also come in _async variants that start the engine and return right away with a handle. The CPU is
+    free until the next driver write, which waits for the BTE first, the same way it waits for the draw engines. Call
+    RA8875_bte_wait to fence explicitly, or pass a callback to hear about completion from the INT interrupt.
+
+*/
+
 /// <summary>
 /// Draws a block of pixels from memory onto the display.
 /// </summary>
-void RA8875_bte_write(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t rop, uint8_t* data);
+esp_err_t RA8875_bte_write(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t rop, uint8_t* data);
+
+/// <summary>
+/// Draws a 1bpp bitmap, expanding set bits to fg and clear bits to bg. If transparent is set, clear bits leave the display untouched instead.
+/// Each row starts on a new byte and the MSB is the leftmost pixel, so a row takes (width + 7) / 8 bytes.
+/// </summary>
+esp_err_t RA8875_bte_expand(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t fg, uint8_t bg, uint8_t transparent, const uint8_t* bits);
 
 /// <summary>
 /// Copies data already on the screen around from one place to another.
 /// </summary>
-void RA8875_bte_move(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t negative, uint8_t rop);
+esp_err_t RA8875_bte_move(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t negative, uint8_t rop);
+
+/// <summary>
+/// Copies data already on the screen like RA8875_bte_move, but source pixels equal to keyColor are skipped and leave the destination untouched.
+/// </summary>
+esp_err_t RA8875_bte_move_transparent(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t keyColor);
 
 /// <summary>
 /// Fills a rectangle on the display.
 /// </summary>
-void RA8875_bte_fill(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t color);
+esp_err_t RA8875_bte_fill(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t color);
+
+/// <summary>
+/// Starts RA8875_bte_move and returns without waiting for it. callback (may be NULL) is called with arg from the INT interrupt when the move finishes.
+/// </summary>
+RA8875_bte_handle_t RA8875_bte_move_async(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t negative, uint8_t rop, RA8875_bte_callback_t callback, void* arg);
+
+/// <summary>
+/// Starts RA8875_bte_move_transparent and returns without waiting for it. See RA8875_bte_move_async.
+/// </summary>
+RA8875_bte_handle_t RA8875_bte_move_transparent_async(RA8875_context_t* ctx, uint16_t srcX, uint16_t srcY, uint8_t srcLayer, uint16_t dstX, uint16_t dstY, uint8_t dstLayer, uint16_t width, uint16_t height, uint8_t keyColor, RA8875_bte_callback_t callback, void* arg);
+
+/// <summary>
+/// Starts RA8875_bte_fill and returns without waiting for it. See RA8875_bte_move_async.
+/// </summary>
+RA8875_bte_handle_t RA8875_bte_fill_async(RA8875_context_t* ctx, uint16_t x, uint16_t y, uint8_t layer, uint16_t width, uint16_t height, uint8_t color, RA8875_bte_callback_t callback, void* arg);
+
+/// <summary>
+/// Waits for an async BTE operation to finish. Returns right away if it already has, and ESP_ERR_TIMEOUT if the RA8875 doesn't signal within RA8875_BTE_TIMEOUT_MS.
+/// </summary>
+esp_err_t RA8875_bte_wait(RA8875_context_t* ctx, RA8875_bte_handle_t handle);
 
@@ -74,6 +74,20 @@
 #define RA8875_VPWR_LOW 0x00  ///< See datasheet
 #define RA8875_VPWR_HIGH 0x80 ///< See datasheet
 
+#define RA8875_FNCR0 0x21        ///< See datasheet
+#define RA8875_FNCR0_CGROM 0x00  ///< See datasheet
+#define RA8875_FNCR0_CGRAM 0x80  ///< See datasheet
+
+#define RA8875_FNCR1 0x22             ///< See datasheet
+#define RA8875_FNCR1_TRANSPARENT 0x40 ///< See datasheet
+
+#define RA8875_CGSR 0x23 ///< See datasheet
+
+#define RA8875_F_CURXL 0x2A ///< See datasheet
+#define RA8875_F_CURXH 0x2B ///< See datasheet
+#define RA8875_F_CURYL 0x2C ///< See datasheet
+#define RA8875_F_CURYH 0x2D ///< See datasheet
+
 #define RA8875_HSAW0 0x30 ///< See datasheet
 #define RA8875_HSAW1 0x31 ///< See datasheet
 #define RA8875_VSAW0 0x32 ///< See datasheet
@@ -84,6 +98,9 @@
 #define RA8875_VEAW0 0x36 ///< See datasheet
 #define RA8875_VEAW1 0x37 ///< See datasheet
 
+#define RA8875_BECR0 0x50 ///< See datasheet
+#define RA8875_BECR1 0x51 ///< See datasheet
+
 #define RA8875_MCLR 0x8E            ///< See datasheet
 #define RA8875_MCLR_START 0x80      ///< See datasheet
 #define RA8875_MCLR_STOP 0x00       ///< See datasheet
@@ -119,6 +136,10 @@
 #define RA8875_MWCR0_TDLR 0x08    ///< Top->Down then Left->Right
 #define RA8875_MWCR0_DTLR 0x0C    ///< Down->Top then Left->Right
 
+#define RA8875_MWCR1 0x41            ///< See datasheet
+#define RA8875_MWCR1_DEST_LAYER 0x00 ///< See datasheet
+#define RA8875_MWCR1_DEST_CGRAM 0x04 ///< See datasheet
+
 #define RA8875_BTCR 0x44  ///< See datasheet
 #define RA8875_CURH0 0x46 ///< See datasheet
 #define RA8875_CURH1 0x47 ///< See datasheet
@@ -1,81 +1,485 @@
 #include "include/RA8875.h"
+#include "include/RA8875_registers.h"
+#include "RA8875_internal.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_memory_utils.h"
 #include <string.h>
 
+#if RA8875_LL_FAST_PATH
+#include "driver/gpio.h"
+#include "hal/spi_ll.h"
+#endif
+
 #define RA8875_DATAWRITE 0x00
 #define RA8875_DATAREAD 0x40
 #define RA8875_CMDWRITE 0x80
 #define RA8875_CMDREAD 0xC0
 
-void RA8875_write_command(RA8875_context_t* ctx, uint8_t reg) {
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));
-    t.length = 8;
-    t.cmd = RA8875_CMDWRITE;
-    t.tx_data[0] = reg;
-    t.flags = SPI_TRANS_USE_TXDATA;
-    esp_err_t ret = spi_device_polling_transmit(ctx->spi_device, &t);
-    assert(ret==ESP_OK);
+esp_err_t RA8875_record_error(RA8875_context_t* ctx, esp_err_t err) {
+    if (err != ESP_OK && ctx->error == ESP_OK)
+        ctx->error = err;
+    return err;
 }
 
-void RA8875_write_data(RA8875_context_t* ctx, uint8_t value) {
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));
-    t.length = 8;
-    t.cmd = RA8875_DATAWRITE;
-    t.tx_data[0] = value;
-    t.flags = SPI_TRANS_USE_TXDATA;
-    esp_err_t ret = spi_device_polling_transmit(ctx->spi_device, &t);
-    assert(ret==ESP_OK);
+static esp_err_t reclaim_transaction(RA8875_context_t* ctx) {
+    spi_transaction_t* done;
+    esp_err_t ret = spi_device_get_trans_result(ctx->spi_write_device, &done, portMAX_DELAY);
+    ctx->queue_pending--;
+
+    //A queued write that failed could have been to any register, so none of the shadow can be trusted
+    if (ret != ESP_OK)
+        RA8875_invalidate_shadow(ctx);
+    return RA8875_record_error(ctx, ret);
 }
 
-void RA8875_write_data_block(RA8875_context_t* ctx, const uint8_t* buffer, int nbytes) {
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));
-    t.length = nbytes * 8;
-    t.cmd = RA8875_DATAWRITE;
-    t.tx_buffer = buffer;
-    t.flags = 0;
-    esp_err_t ret = spi_device_polling_transmit(ctx->spi_device, &t);
-    assert(ret==ESP_OK);
+static esp_err_t drain_queue(RA8875_context_t* ctx) {
+    esp_err_t ret = ESP_OK;
+    while (ctx->queue_pending) {
+        esp_err_t err = reclaim_transaction(ctx);
+        if (ret == ESP_OK)
+            ret = err;
+    }
+    return ret;
+}
+
+static spi_transaction_t* begin_transaction(RA8875_context_t* ctx, spi_transaction_t* local) {
+    //Nothing may be written while an engine is still drawing; this is the only point that waits on it
+    if (ctx->pending)
+        RA8875_wait_idle(ctx);
+
+    spi_transaction_t* t = local;
+    if (ctx->async) {
+        //Transactions complete in order, so when the ring is full the slot we're about to reuse is the oldest one in flight
+        if (ctx->queue_pending == RA8875_QUEUE_DEPTH)
+            reclaim_transaction(ctx);
+        t = &ctx->queue[ctx->queue_head];
+        ctx->queue_head = (ctx->queue_head + 1) % RA8875_QUEUE_DEPTH;
+    }
+    memset(t, 0, sizeof(*t));
+    t->user = ctx;
+    return t;
+}
+
+static esp_err_t submit_transaction(RA8875_context_t* ctx, spi_transaction_t* t) {
+    esp_err_t ret;
+    if (ctx->async) {
+        ret = spi_device_queue_trans(ctx->spi_write_device, t, portMAX_DELAY);
+        if (ret == ESP_OK)
+            ctx->queue_pending++;
+    } else {
+        ret = spi_device_polling_transmit(ctx->spi_write_device, t);
+    }
+    return RA8875_record_error(ctx, ret);
+}
+
+// Registers the controller updates by itself, or where the write is an action rather than a setting. These never go through the shadow.
+static int is_volatile_register(uint8_t reg) {
+    switch (reg) {
+        case RA8875_PWRR:                   // soft reset bit
+        case RA8875_MRWC:                   // memory read/write port
+        case RA8875_F_CURXL ... RA8875_F_CURYH: // text cursor, advances with every character
+        case RA8875_CURH0 ... RA8875_RCURV1: // memory cursors, advance with every pixel
+        case RA8875_BECR0:                  // BTE start
+        case RA8875_MCLR:                   // memory clear start
+        case RA8875_DCR:                    // draw start
+        case RA8875_ELLIPSE:                // draw start
+        case RA8875_INTC2:                  // interrupt flags
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int shadow_is_valid(RA8875_context_t* ctx, uint8_t reg) {
+    return (ctx->shadow_valid[reg >> 3] >> (reg & 7)) & 1;
+}
+
+static void shadow_store(RA8875_context_t* ctx, uint8_t reg, uint8_t value) {
+    ctx->shadow[reg] = value;
+    ctx->shadow_valid[reg >> 3] |= 1 << (reg & 7);
+}
+
+static void shadow_invalidate(RA8875_context_t* ctx, uint8_t reg) {
+    ctx->shadow_valid[reg >> 3] &= ~(1 << (reg & 7));
+}
+
+void RA8875_invalidate_shadow(RA8875_context_t* ctx) {
+    memset(ctx->shadow_valid, 0, sizeof(ctx->shadow_valid));
+}
+
+// Which engine a register write starts, if any
+static uint8_t engine_started(uint8_t reg, uint8_t value) {
+    switch (reg) {
+        case RA8875_DCR:
+            return (value & (RA8875_DCR_LINESQUTRI_START | RA8875_DCR_CIRCLE_START)) ? RA8875_PENDING_DRAW : 0;
+        case RA8875_ELLIPSE:
+            return (value & RA8875_ELLIPSE_STATUS) ? RA8875_PENDING_ELLIPSE : 0;
+        case RA8875_MCLR:
+            return (value & RA8875_MCLR_START) ? RA8875_PENDING_CLEAR : 0;
+        default:
+            return 0;
+    }
+}
+
+esp_err_t RA8875_wait_idle(RA8875_context_t* ctx) {
+    static const struct { uint8_t engine, reg, busy; } engines[] = {
+        { RA8875_PENDING_DRAW, RA8875_DCR, RA8875_DCR_LINESQUTRI_STATUS | RA8875_DCR_CIRCLE_STATUS },
+        { RA8875_PENDING_ELLIPSE, RA8875_ELLIPSE, RA8875_ELLIPSE_STATUS },
+        { RA8875_PENDING_CLEAR, RA8875_MCLR, RA8875_MCLR_READSTATUS },
+    };
+
+    //Cleared up front: the status reads below must not wait on themselves, and a timeout shouldn't stall every later write
+    uint8_t pending = ctx->pending;
+    ctx->pending = 0;
+    if (!pending)
+        return ESP_OK;
+
+    //The BTE signals on the INT pin rather than a status bit
+    if (pending & RA8875_PENDING_BTE) {
+        esp_err_t ret = RA8875_bte_wait(ctx, ctx->bte_started);
+        if (ret != ESP_OK)
+            return ret;
+    }
+
+    TimeOut_t timeout;
+    TickType_t remaining = pdMS_TO_TICKS(RA8875_IDLE_TIMEOUT_MS);
+    vTaskSetTimeOutState(&timeout);
+
+    for (size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        if (!(pending & engines[i].engine))
+            continue;
+
+        //Each engine holds its start bit high until it's done
+        while (RA8875_read_register(ctx, engines[i].reg) & engines[i].busy) {
+            if (xTaskCheckForTimeOut(&timeout, &remaining))
+                return RA8875_record_error(ctx, ESP_ERR_TIMEOUT);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t RA8875_take_error(RA8875_context_t* ctx) {
+    esp_err_t err = ctx->error;
+    ctx->error = ESP_OK;
+    return err;
+}
+
+esp_err_t RA8875_verify(RA8875_context_t* ctx) {
+    //Settings that hold still once written and read back exactly as written: display setup, colors, write mode, font, BTE coordinates
+    static const uint8_t sentinels[] = {
+        RA8875_SYSR, RA8875_HDWR, RA8875_PLLC1, RA8875_PLLC2,
+        RA8875_MWCR0, RA8875_FNCR1, 0x63, 0x64, 0x65, 0x54, 0x58,
+    };
+
+    RA8875_flush(ctx);
+    for (size_t i = 0; i < sizeof(sentinels) / sizeof(sentinels[0]); i++) {
+        uint8_t reg = sentinels[i];
+        if (!shadow_is_valid(ctx, reg))
+            continue;
+
+        uint8_t expected = ctx->shadow[reg];
+        if (RA8875_read_register(ctx, reg) != expected) {
+            //The read refreshed the shadow with what's really there, so put back what we wanted
+            shadow_store(ctx, reg, expected);
+            return RA8875_record_error(ctx, ESP_ERR_INVALID_RESPONSE);
+        }
+    }
+    return ESP_OK;
+}
+
+uint32_t RA8875_get_suppressed_writes(RA8875_context_t* ctx) {
+    return ctx->suppressed_writes;
+}
+
+void RA8875_reset_suppressed_writes(RA8875_context_t* ctx) {
+    ctx->suppressed_writes = 0;
+}
+
+uint32_t RA8875_get_bytes_written(RA8875_context_t* ctx) {
+    return ctx->bytes_written;
+}
+
+void RA8875_reset_bytes_written(RA8875_context_t* ctx) {
+    ctx->bytes_written = 0;
+}
+
+void RA8875_set_async(RA8875_context_t* ctx, uint8_t enabled) {
+    RA8875_flush(ctx);
+    ctx->async = enabled ? 1 : 0;
+}
+
+esp_err_t RA8875_flush(RA8875_context_t* ctx) {
+    esp_err_t ret = drain_queue(ctx);
+    if (ctx->bus_acquired) {
+        spi_device_release_bus(ctx->spi_write_device);
+        ctx->bus_acquired = 0;
+    }
+    return ret;
+}
+
+#if RA8875_LL_FAST_PATH
+// Gets the bus ready for fast_transmit, or returns 0 to send through the driver instead
+static int fast_begin(RA8875_context_t* ctx) {
+    if (!ctx->fast_path)
+        return 0;
+
+    //Same rule as begin_transaction. The status reads give the bus back, so this goes first.
+    if (ctx->pending)
+        RA8875_wait_idle(ctx);
+
+    //Queued transactions still own the peripheral until the driver hands them back
+    drain_queue(ctx);
+    if (!ctx->bus_acquired) {
+        if (RA8875_record_error(ctx, spi_device_acquire_bus(ctx->spi_write_device, portMAX_DELAY)) != ESP_OK)
+            return 0;
+        ctx->bus_acquired = 1;
+    }
+    return 1;
+}
+
+// Sends up to 4 bytes through the peripheral's data registers. Acquiring the bus already applied the write device's clock and mode; this sets everything the driver sets per transaction.
+static void fast_transmit(RA8875_context_t* ctx, const uint8_t* bytes, int nbytes) {
+    spi_dev_t* hw = SPI_LL_GET_HW(ctx->host);
+    int bitlen = nbytes * 8;
+
+    spi_ll_clear_int_stat(hw);
+    spi_ll_set_dummy(hw, 0);
+    spi_ll_set_command_bitlen(hw, 0);
+    spi_ll_set_addr_bitlen(hw, 0);
+    spi_ll_set_mosi_bitlen(hw, bitlen);
+    spi_ll_set_miso_bitlen(hw, bitlen);
+    spi_ll_master_keep_cs(hw, 0);
+    spi_ll_dma_tx_enable(hw, 0);
+    spi_ll_write_buffer(hw, bytes, bitlen);
+    spi_ll_enable_mosi(hw, 1);
+    spi_ll_enable_miso(hw, 0);
+
+    gpio_set_level(ctx->pin_cs, 0);
+    spi_ll_apply_config(hw);
+    spi_ll_user_start(hw);
+    while (!spi_ll_usr_is_done(hw));
+    gpio_set_level(ctx->pin_cs, 1);
+}
+#endif
+
+esp_err_t RA8875_set_fast_path(RA8875_context_t* ctx, uint8_t enabled) {
+#if RA8875_LL_FAST_PATH
+    RA8875_flush(ctx);
+    ctx->fast_path = enabled ? 1 : 0;
+    return ESP_OK;
+#else
+    (void)ctx;
+    return enabled ? ESP_ERR_NOT_SUPPORTED : ESP_OK;
+#endif
+}
+
+// Average time per RA8875_write_register over count writes, flush included
+static uint32_t time_register_writes(RA8875_context_t* ctx, int count) {
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < count; i++)
+        RA8875_write_register(ctx, (i & 1) ? 0x58 : 0x54, (uint8_t)i); //Values change every time, so the shadow skips nothing
+    RA8875_flush(ctx);
+    return (uint32_t)((esp_timer_get_time() - start) * 1000 / count);
+}
+
+RA8875_write_benchmark_t RA8875_benchmark_register_writes(RA8875_context_t* ctx, int count) {
+    RA8875_write_benchmark_t result = { 0, 0 };
+    uint8_t fastPath = ctx->fast_path;
+    if (count <= 0)
+        return result;
+
+    RA8875_set_fast_path(ctx, 0);
+    result.driver_ns = time_register_writes(ctx, count);
+#if RA8875_LL_FAST_PATH
+    RA8875_set_fast_path(ctx, 1);
+    result.fast_ns = time_register_writes(ctx, count);
+#endif
+    RA8875_set_fast_path(ctx, fastPath);
+    return result;
+}
+
+esp_err_t RA8875_write_command(RA8875_context_t* ctx, uint8_t reg) {
+    //Whatever gets written to this register next is sent as raw data, so the shadow can't follow it
+    shadow_invalidate(ctx, reg);
+    ctx->bytes_written += 2;
+
+#if RA8875_LL_FAST_PATH
+    if (fast_begin(ctx)) {
+        const uint8_t bytes[4] = { RA8875_CMDWRITE, reg };
+        fast_transmit(ctx, bytes, 2);
+        return ESP_OK;
+    }
+#endif
+
+    spi_transaction_t local;
+    spi_transaction_t* t = begin_transaction(ctx, &local);
+    t->length = 8;
+    t->cmd = RA8875_CMDWRITE;
+    t->tx_data[0] = reg;
+    t->flags = SPI_TRANS_USE_TXDATA;
+    return submit_transaction(ctx, t);
+}
+
+esp_err_t RA8875_write_data(RA8875_context_t* ctx, uint8_t value) {
+    ctx->bytes_written += 2;
+
+#if RA8875_LL_FAST_PATH
+    if (fast_begin(ctx)) {
+        const uint8_t bytes[4] = { RA8875_DATAWRITE, value };
+        fast_transmit(ctx, bytes, 2);
+        return ESP_OK;
+    }
+#endif
+
+    spi_transaction_t local;
+    spi_transaction_t* t = begin_transaction(ctx, &local);
+    t->length = 8;
+    t->cmd = RA8875_DATAWRITE;
+    t->tx_data[0] = value;
+    t->flags = SPI_TRANS_USE_TXDATA;
+    return submit_transaction(ctx, t);
+}
+
+esp_err_t RA8875_write_data_block(RA8875_context_t* ctx, const uint8_t* buffer, int nbytes) {
+    ctx->bytes_written += 1 + nbytes;
+
+    spi_transaction_t local;
+    spi_transaction_t* t = begin_transaction(ctx, &local);
+    t->length = nbytes * 8;
+    t->cmd = RA8875_DATAWRITE;
+    t->tx_buffer = buffer;
+    t->flags = 0;
+    esp_err_t ret = submit_transaction(ctx, t);
+
+    //The buffer belongs to the caller, so it has to be fully sent before we return. The fast path can keep the bus.
+    esp_err_t flushed = drain_queue(ctx);
+    return ret != ESP_OK ? ret : flushed;
+}
+
+esp_err_t RA8875_write_data_stream(RA8875_context_t* ctx, const uint8_t* buffer, int nbytes) {
+    if (ctx->pending)
+        RA8875_wait_idle(ctx);
+
+    //The ring and the stream share the write device's queue, so let the ring finish first
+    esp_err_t ret = drain_queue(ctx);
+    int direct = esp_ptr_dma_capable(buffer) || !ctx->stream_buf[0] || !ctx->stream_buf[1];
+    int chunk = direct ? RA8875_MAX_TRANSFER : RA8875_STREAM_CHUNK;
+    int slot = 0;
+    int inFlight = 0;
+    spi_transaction_t* done;
+
+    for (int offset = 0; offset < nbytes && ret == ESP_OK; offset += chunk) {
+        //Transactions complete in order, so with both slots busy the oldest one is the slot we're about to reuse
+        if (inFlight == 2) {
+            ret = RA8875_record_error(ctx, spi_device_get_trans_result(ctx->spi_write_device, &done, portMAX_DELAY));
+            inFlight--;
+            if (ret != ESP_OK)
+                break;
+        }
+
+        int len = nbytes - offset < chunk ? nbytes - offset : chunk;
+        const uint8_t* src = &buffer[offset];
+        if (!direct) {
+            memcpy(ctx->stream_buf[slot], src, len);
+            src = ctx->stream_buf[slot];
+        }
+
+        spi_transaction_t* t = &ctx->stream_trans[slot];
+        ctx->bytes_written += 1 + len;
+        memset(t, 0, sizeof(*t));
+        t->user = ctx;
+        t->length = len * 8;
+        t->cmd = RA8875_DATAWRITE;
+        t->tx_buffer = src;
+        ret = RA8875_record_error(ctx, spi_device_queue_trans(ctx->spi_write_device, t, portMAX_DELAY));
+        if (ret == ESP_OK)
+            inFlight++;
+        slot ^= 1;
+    }
+
+    //The buffer belongs to the caller, so it has to be fully sent before we return
+    while (inFlight--) {
+        esp_err_t err = RA8875_record_error(ctx, spi_device_get_trans_result(ctx->spi_write_device, &done, portMAX_DELAY));
+        if (ret == ESP_OK)
+            ret = err;
+    }
+    return ret;
 }
 
 uint8_t RA8875_read_data(RA8875_context_t* ctx) {
+    RA8875_flush(ctx);
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));
+    t.user = ctx;
     t.length = 8;
     t.cmd = RA8875_DATAREAD;
     t.tx_data[0] = 0;
     t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
-    esp_err_t ret = spi_device_polling_transmit(ctx->spi_device, &t);
-    assert(ret==ESP_OK);
+    if (RA8875_record_error(ctx, spi_device_polling_transmit(ctx->spi_device, &t)) != ESP_OK)
+        return 0;
     return t.rx_data[0];
 }
 
-void RA8875_write_register(RA8875_context_t* ctx, uint8_t reg, uint8_t value) {
+esp_err_t RA8875_write_register(RA8875_context_t* ctx, uint8_t reg, uint8_t value) {
+    //Skip the write entirely if the register already holds this value
+    int shadowed = !is_volatile_register(reg);
+    if (shadowed && shadow_is_valid(ctx, reg) && ctx->shadow[reg] == value) {
+        ctx->suppressed_writes++;
+        return ESP_OK;
+    }
+    ctx->bytes_written += 4;
+
+#if RA8875_LL_FAST_PATH
+    if (fast_begin(ctx)) {
+        const uint8_t bytes[4] = { RA8875_CMDWRITE, reg, RA8875_DATAWRITE, value };
+        fast_transmit(ctx, bytes, 4);
+        if (shadowed)
+            shadow_store(ctx, reg, value);
+        ctx->pending |= engine_started(reg, value);
+        return ESP_OK;
+    }
+#endif
+
     //write_command and write_data combined together for optimization
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));
-    t.length = 24;
-    t.cmd = RA8875_CMDWRITE;
-    t.tx_data[0] = reg;
-    t.tx_data[1] = RA8875_DATAWRITE;
-    t.tx_data[2] = value;
-    t.flags = SPI_TRANS_USE_TXDATA;
-    esp_err_t ret = spi_device_polling_transmit(ctx->spi_device, &t);
-    assert(ret==ESP_OK);
+    spi_transaction_t local;
+    spi_transaction_t* t = begin_transaction(ctx, &local);
+    t->length = 24;
+    t->cmd = RA8875_CMDWRITE;
+    t->tx_data[0] = reg;
+    t->tx_data[1] = RA8875_DATAWRITE;
+    t->tx_data[2] = value;
+    t->flags = SPI_TRANS_USE_TXDATA;
+    esp_err_t ret = submit_transaction(ctx, t);
+
+    //Only a write that went out is remembered, or its retry would be skipped. After a failure the register could hold either value.
+    if (shadowed) {
+        if (ret == ESP_OK)
+            shadow_store(ctx, reg, value);
+        else
+            shadow_invalidate(ctx, reg);
+    }
+    ctx->pending |= engine_started(reg, value);
+    return ret;
 }
 
 uint8_t RA8875_read_register(RA8875_context_t* ctx, uint8_t reg) {
     //write_command and read_data combined together for optimization
+    RA8875_flush(ctx);
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));
+    t.user = ctx;
     t.length = 24;
     t.cmd = RA8875_CMDWRITE;
     t.tx_data[0] = reg;
     t.tx_data[1] = RA8875_DATAREAD;
     t.tx_data[2] = 0;
     t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
-    esp_err_t ret = spi_device_polling_transmit(ctx->spi_device, &t);
-    assert(ret==ESP_OK);
+    if (RA8875_record_error(ctx, spi_device_polling_transmit(ctx->spi_device, &t)) != ESP_OK)
+        return 0;
+
+    //A read tells us what the register holds, so the next write of the same value can be skipped
+    if (!is_volatile_register(reg))
+        shadow_store(ctx, reg, t.rx_data[2]);
     return t.rx_data[2];
 }
\ No newline at end of file
@@ -12,10 +12,6 @@ typedef struct {
     uint8_t bitmap[16];
 } Glyph8x16;
 
-typedef struct {
-    uint8_t pixels[16][8];
-} GlyphBuffer;
-
 // Character ' ' (ASCII 32)
 static const Glyph8x16 glyph_32 = {
     .bitmap = {
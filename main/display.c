@@ -4,15 +4,22 @@
 */
 
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
 #include "display.h"
+#include "numfmt.h"
 #include "RA8875.h"
 #include "comicsans_font.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 
 // LCD SPI configuration and pin assignments  
 #define LCD_SPI_HOST              SPI3_HOST
-#define LCD_SPI_SPEED             170000 // 115200 = safe, 170000 = effective, 190000 to 2800000 = highly unstable.
+#define LCD_SPI_SPEED             170000 // Init and reads. 115200 = safe, 170000 = effective, 190000 to 2800000 = highly unstable before the PLL is up.
+#define LCD_SPI_MAX_WRITE_SPEED   20000000 // Writes after RA8875_configure, calibrated at boot up to this (RA8875 system clock / 3)
 #define LCD_PIN_MOSI              13
 #define LCD_PIN_MISO              12
 #define LCD_PIN_SCLK              11
@@ -34,7 +41,7 @@
 #define LCD_BRIGHTNESS_100_PCT    0xFF
 
 // RA8875 register addresses  
-#define RA8875_REG_FONT_SEL       0x21  // Font mode
+#define RA8875_REG_FONT_SEL       0x21  // Font mode (CGROM/CGRAM)
 #define RA8875_REG_FONT_SIZE      0x22  // Font size
 #define RA8875_REG_MODE_CTRL      0x40  // Text vs. Graphic mode
 #define RA8875_REG_FG_R           0x63  // Foreground Red
@@ -49,8 +56,11 @@
 // RA8875 register values
 #define RA8875_VAL_MODE_GRAPHIC   0x00  // Graphic mode
 #define RA8875_VAL_MODE_TEXT      0x80  // Text mode
+#define RA8875_VAL_FONT_CGROM     0x00  // Internal font
+#define RA8875_VAL_FONT_CGRAM     0x80  // User-defined font (Comic Sans once uploaded)
 
 // Colors - 8-bit val interpreted as 3:3:2 RGB in 256-color mode. 7–6 → blue (2 bits) 5–3 → green (3 bits) 2–0 → red (3 bits)
+#define COLOR_BLACK              0
 #define COLOR_WHITE              255   
 #define COLOR_GREEN              32
 #define COLOR_RED                5
@@ -64,19 +74,152 @@
 // Layers
 #define LAYER_DISPLAY            0
 #define LAYER_OFFSCREEN          1
+#define TEMPLATE_HEIGHT          400   // Rows of a screen Display_PrerenderTemplate draws off-screen, above the atlas
+#define LAYER_VALUES             LAYER_DISPLAY    // LAYER_MODE_SPLIT: live values, shown over the chrome
+#define LAYER_CHROME             LAYER_OFFSCREEN  // LAYER_MODE_SPLIT: fills, borders and labels
+#define VALUE_KEY_COLOR          COLOR_BLACK      // LAYER_MODE_SPLIT: value layer pixels of this color show the chrome
+
+// Layer modes: what the second layer of display memory is for
+#define LAYER_MODE_OFFSCREEN     0  // Prerendered template and glyph atlas; screens repaint in place on the visible layer
+#define LAYER_MODE_PAGE_FLIP     1  // Two pages; the next screen is drawn on the hidden one and flipped in with one register write
+#define LAYER_MODE_SPLIT         2  // Static chrome on one layer, live values keyed over it on the other, so value updates never touch the chrome
+#define DISPLAY_LAYER_MODE       LAYER_MODE_PAGE_FLIP
+
+// Comic Sans backends
+#define COMIC_SANS_BACKEND_SPANS 0  // Glyphs drawn as filled rectangles in graphic mode, from build-time rectangle covers
+#define COMIC_SANS_BACKEND_CGRAM 1  // Glyphs uploaded to CGRAM at init and drawn by the text engine
+#define COMIC_SANS_BACKEND_BTE   2  // Whole label packed as a 1bpp bitmap and drawn with one BTE color expansion
+#define COMIC_SANS_BACKEND_ATLAS 3  // Glyphs rasterised once into an off-screen atlas and copied with chroma-keyed BTE moves
+#define COMIC_SANS_BACKEND       COMIC_SANS_BACKEND_CGRAM
+
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_ATLAS && DISPLAY_LAYER_MODE != LAYER_MODE_OFFSCREEN
+#error "The glyph atlas lives on the off-screen layer, so it needs LAYER_MODE_OFFSCREEN"
+#endif
+
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_SPANS
+#include "comicsans_rects.h" // Generated at build time by gen_glyph_rects.py
+#endif
 
 // Misc
 #define GLYPH_SCALE              2
+#define GLYPH_CELL_WIDTH         (8 * GLYPH_SCALE)  // Text engine advance per CGRAM character
+#define FONT_SIZE_COMIC_SANS     (((GLYPH_SCALE - 1) << 2) | (GLYPH_SCALE - 1) | 0x40)  // GLYPH_SCALE x GLYPH_SCALE | transparent background
+#define GLYPH_HEIGHT             (16 * GLYPH_SCALE)
 #define LABELS_Y_OFFSET          11
 #define VALUES_Y_OFFSET          55
-#define DEFAULT_DELAY            20  // Allows rectangles to fully render before switching to text mode
+#define INTERNAL_CHAR_WIDTH      (8 * 3)   // FONT_SIZE_TRIPLE cell
+#define INTERNAL_CHAR_HEIGHT     (16 * 3)
+#define FIELD_TEXT_MAX           12  // Enough for "-999.99999" + '\0'
+#define FIELD_BIT(field)         (1UL << (field))
+#define FIELD_MASK_ALL           (FIELD_BIT(FIELD_COUNT) - 1)
+#define MAX_SCREEN_VALUES        24
+#define LABELS_PER_WATCHDOG_FEED 8
+#define LOG_VALUE_UPDATES        0   // Print how many glyph redraws each Display_FlushUpdates saved
+#define LOG_SCREEN_SWITCHES      0   // Print the register writes the shadow skipped (and glyph atlas hits) on every screen switch
+#define BENCHMARK_REGISTER_WRITES 0   // Print the cost of one register write through the SPI driver vs the low-level fast path at boot
+#define BENCHMARK_CLEARS         0   // Print full-layer vs value-region clear times for every screen at boot
+#define TEMPLATE_CACHE           0   // Keep every screen's fills, borders and Comic Sans labels RLE-compressed in PSRAM and stream them in on a switch
+#define TEMPLATE_CACHE_ROWS      10  // Rows decoded per streamed block; 10 rows of 800 is one RA8875_MAX_TRANSFER
+#define BENCHMARK_TEMPLATE_CACHE 0   // Print live vs cached render times for every screen at boot
+#define DISPLAY_LISTS            1   // Record each screen's static draws once, optimize them, and replay the result on every live render
+#define DISPLAY_LIST_MAX         64  // Draws per screen; a screen with more is drawn immediately
+#define BENCHMARK_DISPLAY_LISTS  0   // Print immediate vs display list SPI bytes for every screen at boot
+#define HEALTH_CHECK_PERIOD_MS   1000 // How often Display_Service checks for lost writes
 #define WATCHDOG_DELAY            5  // Satiates task watchdog when writing text can take too long
 #define ARRAY_LEN(arr) (sizeof(arr) / sizeof((arr)[0]))
+#define SPEC_TABLE(arr) (arr), ARRAY_LEN(arr)
+
+// Glyph atlas (COMIC_SANS_BACKEND_ATLAS)
+#define ATLAS_LAYER              LAYER_OFFSCREEN
+#define ATLAS_Y                  400  // Strip below the 800x400 DEBUG_RTD template
+#define ATLAS_HEIGHT             80
+#define ATLAS_MAX_ENTRIES        128
+#define ATLAS_MAX_SCALE          3
+#define ATLAS_KEY_COLOR          0    // Atlas background, keyed out when glyphs are copied
+#define ATLAS_MOVE_BYTES         (14 * 3)  // Transparent BTE move: 14 register writes
+#define ATLAS_EXPAND_BYTES(w, h) (16 * 3 + (((w) + 7) / 8) * (h))  // Direct BTE color expansion of one glyph
+
+// Seven-segment digits (DISPLAY_FONT_SEGMENT)
+#define SEGMENT_WIDTH            32
+#define SEGMENT_HEIGHT           56
+#define SEGMENT_THICKNESS        6
+#define SEGMENT_CELL_WIDTH       40  // Digit plus spacing
+#define SEG_A                    0x01  // Top
+#define SEG_B                    0x02  // Top right
+#define SEG_C                    0x04  // Bottom right
+#define SEG_D                    0x08  // Bottom
+#define SEG_E                    0x10  // Bottom left
+#define SEG_F                    0x20  // Top left
+#define SEG_G                    0x40  // Middle
+#define SEG_DP                   0x80  // Decimal point
+
+// Warning overlay (Display_RaiseWarning)
+#define OVERLAY_TEXT_MAX         25
+#define OVERLAY_BANNER_HEIGHT    80
+#define OVERLAY_BLINK_MS         500
+#define OVERLAY_SCREEN_LEVEL     4   // Eighths hidden while mixed with the overlay: the screen at half
+#define OVERLAY_LEVEL            4   // and the overlay at half, so the screen stays readable through it
+
+typedef enum {
+    FORMAT_INT,     // Whole number
+    FORMAT_FIXED2,  // Two decimals
+    FORMAT_FIXED5,  // Five decimals (GPS)
+    FORMAT_STRING   // Set with Display_UpdateValueString, i.e. "RR"
+} ValueFormat;
+
+typedef struct {
+    uint16_t x1, y1, x2, y2;
+    uint8_t color;
+} FillSpec;
+
+typedef struct {
+    uint16_t x, y;
+    const char* text;
+    DisplayFont_t font;
+} LabelSpec;
+
+typedef struct {
+    DisplayField_t field;
+    uint16_t x, y;
+    ValueFormat format;
+    DisplayFont_t font;
+    uint8_t bg;  // What's behind the value, used to erase it
+} ValueSpec;
+
+typedef struct {
+    const FillSpec* fills;
+    size_t fillCount;
+    const LineSpec* borders;
+    size_t borderCount;
+    const LabelSpec* labels;
+    size_t labelCount;
+    const ValueSpec* values;
+    size_t valueCount;
+} ScreenSpec;
+
+typedef struct {
+    float number;
+    char text[FIELD_TEXT_MAX];
+} FieldValue;
+
+_Static_assert(FIELD_COUNT < 32, "dirtyFields holds one bit per field");
+_Static_assert(FIELD_TEXT_MAX <= 16, "Display_DrawValues tracks changed cells in a uint16_t");
 
 static RA8875_context_t lcd;
 static DisplayFont_t currentFont = DISPLAY_FONT_INTERNAL;
-static GlyphBuffer glyph_cache[256];
-static bool inGraphicMode = false;
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_BTE
+static uint8_t labelBitmap[(LCD_WIDTH / 8) * GLYPH_HEIGHT]; // One full-width label row, 1bpp
+#elif COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_ATLAS
+typedef struct {
+    uint8_t ch, color, scale;
+    uint16_t x, y;
+} AtlasEntry;
+
+static AtlasEntry atlasEntries[ATLAS_MAX_ENTRIES];
+static uint16_t atlasCount;
+static uint16_t atlasShelfX, atlasShelfY, atlasShelfHeight; // Shelf packing, Y relative to ATLAS_Y
+static uint32_t atlasHits, atlasMisses, atlasBytesSaved;
+#endif
 static const LineSpec mainBordersNoLaps[] = {
     {0, 180, 800, 181}, {0, 360, 800, 361},
     {266, 360, 267, 480}, {533, 360, 534, 480}
@@ -94,6 +237,171 @@ static const LineSpec debugBordersNoRTD[] = {
     {200, 0, 201, 480}, {400, 0, 401, 480}, {600, 0, 601, 480}
 };
 
+// =======================
+// ======= SCREENS =======
+// ======================= 
+
+static const FillSpec mainFillsNoLaps[] = {
+    {0, 90, 800, 180, COLOR_RED}
+};
+static const LabelSpec mainLabelsNoLaps[] = {
+    {350,   0 + LABELS_Y_OFFSET + 50, "Pack %", DISPLAY_FONT_COMIC_SANS},
+    {270, 185 + LABELS_Y_OFFSET + 50, "Distance Traveled", DISPLAY_FONT_COMIC_SANS},
+    {40,  360 + LABELS_Y_OFFSET, "Torque Limit", DISPLAY_FONT_COMIC_SANS}, // No coloring/warning
+    {320, 360 + LABELS_Y_OFFSET, "TC Lat Mode", DISPLAY_FONT_COMIC_SANS},
+    {590, 360 + LABELS_Y_OFFSET, "TV Balance", DISPLAY_FONT_COMIC_SANS},
+};
+static const ValueSpec mainValuesNoLaps[] = {
+    {FIELD_PACK_PCT,     350, 0   + VALUES_Y_OFFSET + 50, FORMAT_FIXED2, DISPLAY_FONT_SEGMENT, COLOR_RED},
+    {FIELD_DISTANCE,     350, 180 + VALUES_Y_OFFSET + 50, FORMAT_FIXED2, DISPLAY_FONT_SEGMENT, COLOR_BLACK},
+    {FIELD_TORQUE_LIMIT, 120, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TC_LAT_MODE,  390, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TV_BALANCE,   660, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+};
+
+static const FillSpec mainFillsLaps[] = {
+    {0, 170, 800, 240, COLOR_RED}
+};
+static const LabelSpec mainLabelsLaps[] = {
+    {30,    0 + LABELS_Y_OFFSET, "Lap Diff", DISPLAY_FONT_COMIC_SANS},
+    {305,   0 + LABELS_Y_OFFSET, "Last Lap Time", DISPLAY_FONT_COMIC_SANS},
+    {640,   0 + LABELS_Y_OFFSET, "Predicted", DISPLAY_FONT_COMIC_SANS},
+    {350, 120 + LABELS_Y_OFFSET, "Pack %", DISPLAY_FONT_COMIC_SANS},
+    {370, 240 + LABELS_Y_OFFSET, "Lap", DISPLAY_FONT_COMIC_SANS},
+    {40,  360 + LABELS_Y_OFFSET, "Torque Limit", DISPLAY_FONT_COMIC_SANS}, // No coloring/warning
+    {315, 360 + LABELS_Y_OFFSET, "TC Lat Mode", DISPLAY_FONT_COMIC_SANS},
+    {590, 360 + LABELS_Y_OFFSET, "TV Balance", DISPLAY_FONT_COMIC_SANS},
+};
+static const ValueSpec mainValuesLaps[] = {
+    {FIELD_LAP_DIFF,       40,  0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_LAST_LAP_TIME,  350, 0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PREDICTED,      660, 0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PACK_PCT,       350, 120 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_SEGMENT, COLOR_RED},
+    {FIELD_LAP,            380, 240 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_SEGMENT, COLOR_BLACK},
+    {FIELD_TORQUE_LIMIT,   120, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TC_LAT_MODE,    380, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TV_BALANCE,     660, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+};
+
+static const LabelSpec debugLabelsNoRTD[] = {
+    {20,  0   + LABELS_Y_OFFSET, "LV Voltage", DISPLAY_FONT_COMIC_SANS},
+    {240, 0   + LABELS_Y_OFFSET, "GPS Long", DISPLAY_FONT_COMIC_SANS},
+    {450, 0   + LABELS_Y_OFFSET, "GPS Lat", DISPLAY_FONT_COMIC_SANS},
+    {615, 0   + LABELS_Y_OFFSET, "Pack Voltage", DISPLAY_FONT_COMIC_SANS},
+    {20,  120 + LABELS_Y_OFFSET, "Motor T Max", DISPLAY_FONT_COMIC_SANS},
+    {240, 120 + LABELS_Y_OFFSET, "APP Arb", DISPLAY_FONT_COMIC_SANS},
+    {400, 120 + LABELS_Y_OFFSET, "Torque Rq Avg", DISPLAY_FONT_COMIC_SANS},
+    {650, 120 + LABELS_Y_OFFSET, "Rotor T", DISPLAY_FONT_COMIC_SANS},
+    {30,  240 + LABELS_Y_OFFSET, "Inv T Max", DISPLAY_FONT_COMIC_SANS},
+    {220, 240 + LABELS_Y_OFFSET, "Steer Angle", DISPLAY_FONT_COMIC_SANS},
+    {410, 240 + LABELS_Y_OFFSET, "F Brake Bias", DISPLAY_FONT_COMIC_SANS},
+    {650, 240 + LABELS_Y_OFFSET, "Logging", DISPLAY_FONT_COMIC_SANS},
+    {20,  360 + LABELS_Y_OFFSET, "Min Cell V", DISPLAY_FONT_COMIC_SANS},
+    {220, 360 + LABELS_Y_OFFSET, "Peak Cell T", DISPLAY_FONT_COMIC_SANS},
+    {405, 360 + LABELS_Y_OFFSET, "F Brake Press", DISPLAY_FONT_COMIC_SANS},
+    {620, 360 + LABELS_Y_OFFSET, "Power Limit", DISPLAY_FONT_COMIC_SANS},
+    {50,  360 + VALUES_Y_OFFSET, ",i=", DISPLAY_FONT_INTERNAL}, // Min Cell V index
+    {250, 360 + VALUES_Y_OFFSET, ",i=", DISPLAY_FONT_INTERNAL}, // Peak Cell T index
+};
+static const ValueSpec debugValuesNoRTD[] = {
+    {FIELD_LV_VOLTAGE,         50,  0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_GPS_LONG,           215, 0   + VALUES_Y_OFFSET, FORMAT_FIXED5, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_GPS_LAT,            415, 0   + VALUES_Y_OFFSET, FORMAT_FIXED5, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PACK_VOLTAGE,       650, 0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MOTOR_T_MAX,        40,  120 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MOTOR_T_MAX_CORNER, 80,  120 + VALUES_Y_OFFSET, FORMAT_STRING, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_APP_ARB,            250, 120 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TORQUE_RQ_AVG,      450, 120 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_ROTOR_T,            690, 120 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_INV_T_MAX,          40,  240 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_INV_T_MAX_CORNER,   80,  240 + VALUES_Y_OFFSET, FORMAT_STRING, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_STEER_ANGLE,        250, 240 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_F_BRAKE_BIAS,       450, 240 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_LOGGING,            690, 240 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MIN_CELL_V,         30,  360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MIN_CELL_V_INDEX,   120, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PEAK_CELL_T,        230, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PEAK_CELL_T_INDEX,  320, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_F_BRAKE_PRESS,      450, 360 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_POWER_LIMIT,        690, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+};
+
+static const FillSpec debugFillsRTD[] = {
+    {200, 170, 600, 240, COLOR_RED}
+};
+static const LabelSpec debugLabelsRTD[] = {
+    {20,  0   + LABELS_Y_OFFSET, "LV Voltage", DISPLAY_FONT_COMIC_SANS},
+    {305, 0   + LABELS_Y_OFFSET, "Last Lap Time", DISPLAY_FONT_COMIC_SANS},
+    {610, 0   + LABELS_Y_OFFSET, "Pack Voltage", DISPLAY_FONT_COMIC_SANS},
+    {10,  120 + LABELS_Y_OFFSET, "Motor T Max", DISPLAY_FONT_COMIC_SANS},
+    {355, 120 + LABELS_Y_OFFSET, "Pack %", DISPLAY_FONT_COMIC_SANS},
+    {650, 120 + LABELS_Y_OFFSET, "Rotor T", DISPLAY_FONT_COMIC_SANS},
+    {30,  240 + LABELS_Y_OFFSET, "Inv T Max", DISPLAY_FONT_COMIC_SANS},
+    {380, 240 + LABELS_Y_OFFSET, "Lap", DISPLAY_FONT_COMIC_SANS},
+    {610, 240 + LABELS_Y_OFFSET, "Torque Limit", DISPLAY_FONT_COMIC_SANS}, // No coloring/warning
+    {20,  360 + LABELS_Y_OFFSET, "Min Cell V", DISPLAY_FONT_COMIC_SANS},
+    {220, 360 + LABELS_Y_OFFSET, "Peak Cell T", DISPLAY_FONT_COMIC_SANS},
+    {405, 360 + LABELS_Y_OFFSET, "F Brake Press", DISPLAY_FONT_COMIC_SANS},
+    {640, 360 + LABELS_Y_OFFSET, "TC", DISPLAY_FONT_COMIC_SANS},
+    {740, 360 + LABELS_Y_OFFSET, "TV", DISPLAY_FONT_COMIC_SANS},
+    {40,  360 + VALUES_Y_OFFSET, ",i=", DISPLAY_FONT_INTERNAL}, // Min Cell V index
+    {240, 360 + VALUES_Y_OFFSET, ",i=", DISPLAY_FONT_INTERNAL}, // Peak Cell T index
+};
+static const ValueSpec debugValuesRTD[] = {
+    {FIELD_LV_VOLTAGE,         50,  0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_LAST_LAP_TIME,      355, 0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PACK_VOLTAGE,       655, 0   + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MOTOR_T_MAX,        50,  120 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MOTOR_T_MAX_CORNER, 90,  120 + VALUES_Y_OFFSET, FORMAT_STRING, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PACK_PCT,           355, 120 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_RED},
+    {FIELD_ROTOR_T,            690, 120 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_INV_T_MAX,          50,  240 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_INV_T_MAX_CORNER,   90,  240 + VALUES_Y_OFFSET, FORMAT_STRING, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_LAP,                390, 240 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TORQUE_LIMIT,       690, 240 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MIN_CELL_V,         20,  360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_MIN_CELL_V_INDEX,   120, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PEAK_CELL_T,        220, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_PEAK_CELL_T_INDEX,  320, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_F_BRAKE_PRESS,      455, 360 + VALUES_Y_OFFSET, FORMAT_FIXED2, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TC_LAT_MODE,        640, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+    {FIELD_TV_BALANCE,         740, 360 + VALUES_Y_OFFSET, FORMAT_INT, DISPLAY_FONT_INTERNAL, COLOR_BLACK},
+};
+
+// Indexed by Screen_t. SCREEN_WARN is drawn by Display_Warn and has no fields.
+static const ScreenSpec screenSpecs[] = {
+    [SCREEN_MAIN_NO_LAPS] = {
+        SPEC_TABLE(mainFillsNoLaps), SPEC_TABLE(mainBordersNoLaps),
+        SPEC_TABLE(mainLabelsNoLaps), SPEC_TABLE(mainValuesNoLaps)
+    },
+    [SCREEN_MAIN_LAPS] = {
+        SPEC_TABLE(mainFillsLaps), SPEC_TABLE(mainBordersLaps),
+        SPEC_TABLE(mainLabelsLaps), SPEC_TABLE(mainValuesLaps)
+    },
+    [SCREEN_DEBUG_RTD] = {
+        SPEC_TABLE(debugFillsRTD), SPEC_TABLE(debugBordersRTD),
+        SPEC_TABLE(debugLabelsRTD), SPEC_TABLE(debugValuesRTD)
+    },
+    [SCREEN_DEBUG_NO_RTD] = {
+        NULL, 0, SPEC_TABLE(debugBordersNoRTD),
+        SPEC_TABLE(debugLabelsNoRTD), SPEC_TABLE(debugValuesNoRTD)
+    },
+};
+
+// Latest values, shared by every screen showing the same field
+static FieldValue fieldValues[FIELD_COUNT] = {
+    [FIELD_MOTOR_T_MAX_CORNER] = { .text = "RR" },
+    [FIELD_INV_T_MAX_CORNER] = { .text = "RR" },
+};
+static uint32_t dirtyFields;  // FIELD_BIT per field changed since the last flush
+static char drawnPages[2][MAX_SCREEN_VALUES][FIELD_TEXT_MAX];  // What each value slot shows on each layer, "" if nothing
+static char (*drawnValues)[FIELD_TEXT_MAX] = drawnPages[LAYER_DISPLAY];  // The entry for drawLayer
+static uint8_t drawLayer = LAYER_DISPLAY;  // Layer everything is drawn on
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+static uint8_t visiblePage = LAYER_DISPLAY;
+static int pageScreen[2] = {-1, -1};  // Screen_t each page was last rendered with, -1 if none
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Woverride-init" // Suppress overrides warnings
 static const uint8_t glyphAdvanceComicSans[256] = { // Allows for custom spacing for wider or narrower letters
@@ -103,7 +411,85 @@ static const uint8_t glyphAdvanceComicSans[256] = { // Allows for custom spacing
 };
 #pragma GCC diagnostic pop
 
+// A-G are disjoint: bars span the inner columns, uprights take the full half-height including corners, so erasing one can't clip another.
+// The decimal point overlaps D, which is why Display_DrawSegmentDigit erases every segment turning off before it lights any turning on.
+static const LineSpec segmentRects[8] = {
+    {SEGMENT_THICKNESS, 0, SEGMENT_WIDTH - SEGMENT_THICKNESS - 1, SEGMENT_THICKNESS - 1},                               // A
+    {SEGMENT_WIDTH - SEGMENT_THICKNESS, 0, SEGMENT_WIDTH - 1, SEGMENT_HEIGHT / 2 - 1},                                  // B
+    {SEGMENT_WIDTH - SEGMENT_THICKNESS, SEGMENT_HEIGHT / 2, SEGMENT_WIDTH - 1, SEGMENT_HEIGHT - 1},                     // C
+    {SEGMENT_THICKNESS, SEGMENT_HEIGHT - SEGMENT_THICKNESS, SEGMENT_WIDTH - SEGMENT_THICKNESS - 1, SEGMENT_HEIGHT - 1}, // D
+    {0, SEGMENT_HEIGHT / 2, SEGMENT_THICKNESS - 1, SEGMENT_HEIGHT - 1},                                                 // E
+    {0, 0, SEGMENT_THICKNESS - 1, SEGMENT_HEIGHT / 2 - 1},                                                              // F
+    {SEGMENT_THICKNESS, (SEGMENT_HEIGHT - SEGMENT_THICKNESS) / 2, SEGMENT_WIDTH - SEGMENT_THICKNESS - 1, (SEGMENT_HEIGHT + SEGMENT_THICKNESS) / 2 - 1}, // G
+    {(SEGMENT_WIDTH - SEGMENT_THICKNESS) / 2, SEGMENT_HEIGHT - SEGMENT_THICKNESS, (SEGMENT_WIDTH + SEGMENT_THICKNESS) / 2 - 1, SEGMENT_HEIGHT - 1}, // DP
+};
+
+static const uint8_t segmentsForChar[128] = {
+    ['0'] = SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,
+    ['1'] = SEG_B | SEG_C,
+    ['2'] = SEG_A | SEG_B | SEG_D | SEG_E | SEG_G,
+    ['3'] = SEG_A | SEG_B | SEG_C | SEG_D | SEG_G,
+    ['4'] = SEG_B | SEG_C | SEG_F | SEG_G,
+    ['5'] = SEG_A | SEG_C | SEG_D | SEG_F | SEG_G,
+    ['6'] = SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
+    ['7'] = SEG_A | SEG_B | SEG_C,
+    ['8'] = SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
+    ['9'] = SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G,
+    ['-'] = SEG_G,
+    ['.'] = SEG_DP,
+};
+
 Screen_t CURRENT_SCREEN;
+static TickType_t lastHealthCheck;
+
+static char overlayText[OVERLAY_TEXT_MAX];
+static bool overlayRaised;       // Between Display_RaiseWarning and Display_ClearWarning
+static bool overlayFullScreen;
+static bool overlayBlink;
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+static bool overlayShown;        // Blink phase
+#endif
+static TickType_t overlayRaisedAt, overlayToggledAt, overlayDuration;  // overlayDuration 0 = until cleared
+
+static Screen_t predictedScreen;  // Display_SetNextScreen
+static bool predictionPending;    // Display_Service hasn't prerendered predictedScreen yet
+#if DISPLAY_LAYER_MODE == LAYER_MODE_OFFSCREEN
+static const ScreenSpec* templateSpec;  // Screen the off-screen template holds, NULL if none
+#endif
+
+#if TEMPLATE_CACHE
+typedef struct {
+    uint8_t* runs;  // (count, color) byte pairs covering the screen row by row, NULL if not cached
+    size_t size;
+} TemplateCacheEntry;
+
+static TemplateCacheEntry templateCache[ARRAY_LEN(screenSpecs)];
+static uint8_t templateBlock[TEMPLATE_CACHE_ROWS * LCD_WIDTH];  // Internal RAM, so decoded blocks go out by DMA without a bounce copy
+#endif
+
+#if DISPLAY_LISTS
+typedef enum {
+    DISPLAY_OP_RECT,  // Filled rectangle, arg is the color
+    DISPLAY_OP_TEXT   // Transparent white text at (x1, y1), arg is the DisplayFont_t
+} DisplayOpKind;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t arg;
+    uint16_t x1, y1, x2, y2;  // Inclusive bounds. For text, the cells it can touch.
+    const char* text;         // Label text, which lives in the screen tables
+} DisplayOp;
+
+typedef struct {
+    DisplayOp ops[DISPLAY_LIST_MAX];
+    uint8_t count;
+    uint8_t recorded;  // Count before optimizing
+    bool valid;        // Everything recorded fit and can be replayed
+} DisplayList;
+
+static DisplayList displayLists[ARRAY_LEN(screenSpecs)];
+static DisplayList* recordingList;  // While set, Display_DrawRect and Display_WriteTextAt append here instead of drawing
+#endif
 
 static void Display_ForegroundWhite(void) 
 {
@@ -116,23 +502,168 @@ static void Display_InternalFontSize(uint8_t size)
 {
     RA8875_write_register(&lcd, RA8875_REG_FONT_SIZE, size);
     RA8875_write_register(&lcd, RA8875_REG_FONT_SRC, 0x00);
-    RA8875_write_register(&lcd, RA8875_REG_FONT_SEL, 0x00);
+    RA8875_write_register(&lcd, RA8875_REG_FONT_SEL, RA8875_VAL_FONT_CGROM);
 }
 
-static void Display_PrecomputeGlyphs(void)
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_CGRAM
+static void Display_UploadComicSans(void)
 {
     for (int i = 0; i < 256; i++) {
-        const Glyph8x16* g = glyphs[i];
-        if (!g) continue;
+        if (glyphs[i]) {
+            RA8875_write_cgram(&lcd, i, glyphs[i]->bitmap);
+        }
+    }
+}
 
-        for (int row = 0; row < 16; row++) {
-            uint8_t bits = g->bitmap[row];
-            for (int col = 0; col < 8; col++) {
-                glyph_cache[i].pixels[row][col] = (bits & (1 << (7 - col))) ? 1 : 0;
+static void Display_ComicSansFont(void)
+{
+    RA8875_write_register(&lcd, RA8875_REG_FONT_SIZE, FONT_SIZE_COMIC_SANS);
+    RA8875_write_register(&lcd, RA8875_REG_FONT_SRC, 0x00);
+    RA8875_write_register(&lcd, RA8875_REG_FONT_SEL, RA8875_VAL_FONT_CGRAM);
+}
+#endif
+
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_BTE || COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_ATLAS
+// ORs a glyph, enlarged scale times, into a 1bpp bitmap at pixel column originX
+static void Display_PackGlyph(uint8_t* bits, uint16_t stride, uint16_t originX, const Glyph8x16* glyph, uint8_t scale)
+{
+    for (int row = 0; row < 16; row++) {
+        uint8_t rowBits = glyph->bitmap[row];
+        if (!rowBits) continue;
+
+        for (int col = 0; col < 8; col++) {
+            if (!(rowBits & (1 << (7 - col)))) continue;
+
+            for (int sy = 0; sy < scale; sy++) {
+                uint8_t* line = bits + (row * scale + sy) * stride;
+                for (int sx = 0; sx < scale; sx++) {
+                    uint16_t px = originX + col * scale + sx;
+                    line[px >> 3] |= 0x80 >> (px & 7);
+                }
             }
         }
     }
 }
+#endif
+
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_BTE
+// Packs a whole label into labelBitmap and draws it with a single BTE color expansion
+static void Display_WriteComicSans(uint16_t x, uint16_t y, const char* msg)
+{
+    // Measure first so rows can be packed at the label's own stride
+    uint16_t width = 0;
+    uint16_t cursorX = 0;
+    for (const char* c = msg; *c; c++) {
+        uint8_t ch = (uint8_t)*c;
+        if (!glyphs[ch]) continue;
+        if (cursorX + GLYPH_CELL_WIDTH > width) width = cursorX + GLYPH_CELL_WIDTH;
+        cursorX += glyphAdvanceComicSans[ch];
+    }
+    if (width > LCD_WIDTH - x) width = LCD_WIDTH - x;
+    if (!width) return;
+
+    uint16_t stride = (width + 7) / 8;
+    memset(labelBitmap, 0, stride * GLYPH_HEIGHT);
+
+    cursorX = 0;
+    while (*msg) {
+        uint8_t ch = (uint8_t)*msg++;
+        if (!glyphs[ch]) continue;
+        if (cursorX + GLYPH_CELL_WIDTH > width) break;
+        Display_PackGlyph(labelBitmap, stride, cursorX, glyphs[ch], GLYPH_SCALE);
+        cursorX += glyphAdvanceComicSans[ch];
+    }
+
+    RA8875_bte_expand(&lcd, x, y, drawLayer, width, GLYPH_HEIGHT, COLOR_WHITE, 0, true, labelBitmap);
+}
+#elif COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_ATLAS
+// Rasterises a glyph into a cell-sized 1bpp bitmap and draws it with a BTE color expansion
+static void Display_ExpandGlyph(uint16_t x, uint16_t y, uint8_t layer, uint8_t ch, uint8_t color, uint8_t scale, bool transparent)
+{
+    uint8_t cell[ATLAS_MAX_SCALE * 16 * ATLAS_MAX_SCALE]; // (8 * scale / 8) bytes per row
+    uint16_t w = 8 * scale;
+    uint16_t h = 16 * scale;
+    uint16_t stride = (w + 7) / 8;
+
+    memset(cell, 0, stride * h);
+    Display_PackGlyph(cell, stride, 0, glyphs[ch], scale);
+    RA8875_bte_expand(&lcd, x, y, layer, w, h, color, ATLAS_KEY_COLOR, transparent, cell);
+}
+
+// Finds a glyph in the atlas, rasterising it into the next free cell on first use. Returns NULL if it can't be cached.
+static const AtlasEntry* Display_AtlasLookup(uint8_t ch, uint8_t color, uint8_t scale)
+{
+    for (uint16_t i = 0; i < atlasCount; i++) {
+        const AtlasEntry* e = &atlasEntries[i];
+        if (e->ch == ch && e->color == color && e->scale == scale) {
+            atlasHits++;
+            return e;
+        }
+    }
+
+    atlasMisses++;
+    if (color == ATLAS_KEY_COLOR || scale > ATLAS_MAX_SCALE || atlasCount == ATLAS_MAX_ENTRIES) return NULL;
+
+    // Shelf packing: fill rows left to right, start a new shelf when this one is full
+    uint16_t w = 8 * scale;
+    uint16_t h = 16 * scale;
+    if (atlasShelfX + w > LCD_WIDTH) {
+        atlasShelfY += atlasShelfHeight;
+        atlasShelfX = 0;
+        atlasShelfHeight = 0;
+    }
+    if (atlasShelfY + h > ATLAS_HEIGHT) return NULL;
+
+    AtlasEntry* e = &atlasEntries[atlasCount++];
+    e->ch = ch;
+    e->color = color;
+    e->scale = scale;
+    e->x = atlasShelfX;
+    e->y = ATLAS_Y + atlasShelfY;
+    atlasShelfX += w;
+    if (h > atlasShelfHeight) atlasShelfHeight = h;
+
+    Display_ExpandGlyph(e->x, e->y, ATLAS_LAYER, ch, color, scale, false);
+    return e;
+}
+
+static void Display_AtlasWrite(uint16_t x, uint16_t y, const char* msg, uint8_t color, uint8_t scale)
+{
+    uint16_t cursorX = x;
+    uint16_t w = 8 * scale;
+    uint16_t h = 16 * scale;
+
+    while (*msg) {
+        uint8_t ch = (uint8_t)*msg++;
+        if (!glyphs[ch]) continue;
+
+        const AtlasEntry* e = Display_AtlasLookup(ch, color, scale);
+        if (e) {
+            RA8875_bte_move_transparent(&lcd, e->x, e->y, ATLAS_LAYER, cursorX, y, drawLayer, w, h, ATLAS_KEY_COLOR);
+            atlasBytesSaved += ATLAS_EXPAND_BYTES(w, h) - ATLAS_MOVE_BYTES;
+        } else {
+            Display_ExpandGlyph(cursorX, y, drawLayer, ch, color, scale, true); // Atlas full or color can't be keyed
+        }
+        cursorX += glyphAdvanceComicSans[ch] * scale / GLYPH_SCALE;
+    }
+}
+
+// Rasterises the default style of every glyph at boot so labels never miss
+static void Display_AtlasInit(void)
+{
+    for (int i = 0; i < 256; i++) {
+        if (glyphs[i]) {
+            Display_AtlasLookup(i, COLOR_WHITE, GLYPH_SCALE);
+        }
+    }
+    atlasHits = atlasMisses = 0;
+}
+
+static void Display_WriteComicSans(uint16_t x, uint16_t y, const char* msg)
+{
+    Display_AtlasWrite(x, y, msg, COLOR_WHITE, GLYPH_SCALE);
+}
+#endif
 
 static void Display_SetTextCursor(uint16_t x, uint16_t y) 
 {
@@ -142,42 +673,81 @@ static void Display_SetTextCursor(uint16_t x, uint16_t y)
     RA8875_write_register(&lcd, RA8875_REG_CURSOR_Y_HIGH, y >> 8);
 }
 
-static void Display_ResetState(void)
+// Points text, drawing, and BTE output at a layer, along with the record of which values it shows
+static void Display_SetDrawLayer(uint8_t layer)
 {
-    RA8875_clear(&lcd);
+    drawLayer = layer;
+    drawnValues = drawnPages[layer];
+    RA8875_set_writing_layer(&lcd, layer);
+}
+
+// Clears rows top to bottom of the draw layer, and resets the text cursor and color
+static void Display_ResetState(uint16_t top, uint16_t bottom)
+{
+    if (top == 0 && bottom >= LCD_HEIGHT - 1) {
+        RA8875_clear(&lcd);
+    } else {
+        RA8875_clear_region(&lcd, 0, top, LCD_WIDTH - 1, bottom, drawLayer, COLOR_BLACK);
+    }
     Display_SetTextCursor(0, 0);
     Display_ForegroundWhite();
 }
 
-// Span batching + Caching for faster special font load
-static void Display_BlitGlyph(uint16_t x, uint16_t y, const GlyphBuffer* buf)
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_SPANS
+// Draws a glyph from its precomputed rectangle cover (flash-resident, see gen_glyph_rects.py)
+static void Display_BlitGlyph(uint16_t x, uint16_t y, uint8_t ch)
 {
     const uint8_t scale = GLYPH_SCALE;
     Display_ForegroundWhite();
 
-    for (int col = 0; col < 8; col++) {
-        uint16_t px1 = x + col * scale;
-        uint16_t px2 = px1 + scale - 1;
+    for (uint16_t i = glyphRectOffset[ch]; i < glyphRectOffset[ch + 1]; i++) {
+        uint16_t rect = glyphRects[i];
+        uint16_t px1 = x + GLYPH_RECT_X(rect) * scale;
+        uint16_t py1 = y + GLYPH_RECT_Y(rect) * scale;
+        uint16_t px2 = px1 + GLYPH_RECT_W(rect) * scale - 1;
+        uint16_t py2 = py1 + GLYPH_RECT_H(rect) * scale - 1;
+        RA8875_draw_rect_fast(&lcd, px1, py1, px2, py2);
+    }
+}
 
-        int row = 0;
-        while (row < 16) {
-            if (!buf->pixels[row][col]) {
-                row++;
-                continue;
-            }
+static void Display_WriteComicSans(uint16_t x, uint16_t y, const char* msg)
+{
+    uint16_t cursorX = x;
 
-            int start_row = row;
-            
-            while (row < 16 && buf->pixels[row][col]) {
-                row++;
-            }
+    while (*msg) {
+        uint8_t ch = (uint8_t)*msg++;
+        const Glyph8x16* glyph = glyphs[ch];
+
+        if (glyph) {
+            Display_BlitGlyph(cursorX, y, ch);
+            cursorX += glyphAdvanceComicSans[ch];
+        }
+    }
+}
+#elif COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_CGRAM
+// Glyphs live in CGRAM under their own character code, so each one is a single data byte
+static void Display_WriteComicSans(uint16_t x, uint16_t y, const char* msg)
+{
+    uint16_t cursorX = x;
 
-            uint16_t py1 = y + start_row * scale;
-            uint16_t py2 = y + (row - 1) * scale + scale - 1;
-            RA8875_draw_rect_fast(&lcd, px1, py1, px2, py2);
+    Display_SetTextCursor(x, y);
+    RA8875_write_command(&lcd, 0x02);
+
+    while (*msg) {
+        uint8_t ch = (uint8_t)*msg++;
+        if (!glyphs[ch]) continue;
+
+        RA8875_write_data(&lcd, ch);
+        cursorX += glyphAdvanceComicSans[ch];
+
+        // The text engine always advances by one cell, so move the cursor when this character is narrower or wider
+        if (glyphAdvanceComicSans[ch] != GLYPH_CELL_WIDTH && *msg) {
+            Display_SetTextCursor(cursorX, y);
+            RA8875_write_command(&lcd, 0x02);
         }
     }
 }
+#endif
 
 static void Display_DrawBorders(const LineSpec* lines, size_t count)
 {
@@ -186,342 +756,1135 @@ static void Display_DrawBorders(const LineSpec* lines, size_t count)
     }
 }
 
-static void Display_RenderMainScreen(bool isLaps)
+static void Display_DrawFills(const FillSpec* fills, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        Display_DrawRect(fills[i].x1, fills[i].y1, fills[i].x2, fills[i].y2, fills[i].color, true);
+    }
+}
+
+// Draws the screen's labels in one font, so each font costs a single mode switch
+static void Display_DrawLabels(const ScreenSpec* spec, DisplayFont_t font)
 {
-    Display_ResetState();
+    size_t drawn = 0;
 
-    // =======================
-    // ====== DRAWINGS =======
-    // ======================= 
+    for (size_t i = 0; i < spec->labelCount; ++i) {
+        const LabelSpec* label = &spec->labels[i];
+        if (label->font != font) continue;
 
-    Display_EnableDrawMode();
+        if (drawn == 0) Display_EnableTextModeAndFont(font);
+        Display_WriteTextAt(label->x, label->y, label->text);
 
-    // Rectangles 
-    if (isLaps) {
-        Display_DrawRect(0, 170, 800, 240, COLOR_RED, true);
-    } else {
-        Display_DrawRect(0, 90, 800, 180, COLOR_RED, true);
+        if (++drawn % LABELS_PER_WATCHDOG_FEED == 0) {
+            vTaskDelay(pdMS_TO_TICKS(WATCHDOG_DELAY));
+        }
     }
-    
-    // White Borders in Main Screen
-    if (isLaps) {
-        Display_DrawBorders(mainBordersLaps, ARRAY_LEN(mainBordersLaps));
-    } else {
-        Display_DrawBorders(mainBordersNoLaps, ARRAY_LEN(mainBordersNoLaps));
+}
+
+#if TEMPLATE_CACHE
+// Fills a horizontal span of a row buffer, clipped to the screen like the draw engine does. x2 is inclusive.
+static void Display_FillRowSpan(uint8_t* row, uint16_t x1, uint16_t x2, uint8_t color)
+{
+    if (x1 >= LCD_WIDTH) return;
+    if (x2 >= LCD_WIDTH) x2 = LCD_WIDTH - 1;
+    if (x2 >= x1) memset(&row[x1], color, x2 - x1 + 1);
+}
+
+// Software version of what Display_RenderScreen draws before the internal-font labels and values, one row at a time
+static void Display_RasterizeTemplateRow(const ScreenSpec* spec, uint16_t y, uint8_t* row)
+{
+    memset(row, COLOR_BLACK, LCD_WIDTH);
+
+    for (size_t i = 0; i < spec->fillCount; ++i) {
+        const FillSpec* f = &spec->fills[i];
+        if (y >= f->y1 && y <= f->y2) Display_FillRowSpan(row, f->x1, f->x2, f->color);
     }
+    for (size_t i = 0; i < spec->borderCount; ++i) {
+        const LineSpec* b = &spec->borders[i];
+        if (y >= b->y1 && y <= b->y2) Display_FillRowSpan(row, b->x1, b->x2, COLOR_WHITE);
+    }
+    for (size_t i = 0; i < spec->labelCount; ++i) {
+        const LabelSpec* label = &spec->labels[i];
+        if (label->font != DISPLAY_FONT_COMIC_SANS || y < label->y || y >= label->y + GLYPH_HEIGHT) continue;
 
-    vTaskDelay(pdMS_TO_TICKS(DEFAULT_DELAY));
+        uint16_t cursorX = label->x;
+        for (const char* c = label->text; *c; c++) {
+            uint8_t ch = (uint8_t)*c;
+            if (!glyphs[ch]) continue;
 
-    // =======================
-    // ======== TEXT =========
-    // ======================= 
-    
-    // Text Labels 
-    Display_EnableTextModeAndFont(DISPLAY_FONT_COMIC_SANS); 
-
-    if (isLaps) {
-        Display_WriteTextAt(30,    0 + LABELS_Y_OFFSET, "Lap Diff");
-        Display_WriteTextAt(305,   0 + LABELS_Y_OFFSET, "Last Lap Time");
-        Display_WriteTextAt(640,   0 + LABELS_Y_OFFSET, "Predicted");
-        Display_WriteTextAt(350, 120 + LABELS_Y_OFFSET, "Pack %");
-        Display_WriteTextAt(370, 240 + LABELS_Y_OFFSET, "Lap");
-        Display_WriteTextAt(40,  360 + LABELS_Y_OFFSET, "Torque Limit"); // No coloring/warning
-        Display_WriteTextAt(315, 360 + LABELS_Y_OFFSET, "TC Lat Mode");
-        Display_WriteTextAt(590, 360 + LABELS_Y_OFFSET, "TV Balance");
-    } else {
-        Display_WriteTextAt(350,   0 + LABELS_Y_OFFSET + 50, "Pack %");
-        Display_WriteTextAt(270, 185 + LABELS_Y_OFFSET + 50, "Distance Traveled");
-        Display_WriteTextAt(40,  360 + LABELS_Y_OFFSET, "Torque Limit"); // No coloring/warning
-        Display_WriteTextAt(320, 360 + LABELS_Y_OFFSET, "TC Lat Mode");
-        Display_WriteTextAt(590, 360 + LABELS_Y_OFFSET, "TV Balance");
-    }
-
-    // Text Values
-    float defaultFloat = 0.00;
-    int defaultInt = 0;
-    
-    Display_EnableTextModeAndFont(DISPLAY_FONT_INTERNAL);  
-
-    if (isLaps) {
-        Display_WriteNumberAt(40,  0   + VALUES_Y_OFFSET, false, defaultFloat, false); // Lap Diff
-        Display_WriteNumberAt(350, 0   + VALUES_Y_OFFSET, false, defaultFloat, false); // Last Lap Time
-        Display_WriteNumberAt(660, 0   + VALUES_Y_OFFSET, false, defaultFloat, false); // Predicted
-        Display_WriteNumberAt(350, 120 + VALUES_Y_OFFSET, false, defaultFloat, false); // Pack %
-        Display_WriteNumberAt(380, 240 + VALUES_Y_OFFSET, true, defaultInt, false); // Lap
-        Display_WriteNumberAt(120, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // Torque Limit
-        Display_WriteNumberAt(380, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // TC Lat Mode
-        Display_WriteNumberAt(660, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // TV Balance
+            uint8_t bits = glyphs[ch]->bitmap[(y - label->y) / GLYPH_SCALE];
+            for (int col = 0; col < 8; col++) {
+                if (bits & (0x80 >> col)) {
+                    uint16_t px = cursorX + col * GLYPH_SCALE;
+                    Display_FillRowSpan(row, px, px + GLYPH_SCALE - 1, COLOR_WHITE);
+                }
+            }
+            cursorX += glyphAdvanceComicSans[ch];
+        }
+    }
+}
+
+// Run-length encodes a screen's template, row after row with runs crossing rows. Returns the encoded size; out may be NULL to only measure.
+static size_t Display_EncodeTemplate(const ScreenSpec* spec, uint8_t* out)
+{
+    uint8_t row[LCD_WIDTH];
+    size_t size = 0;
+    uint8_t count = 0, color = 0;
+
+    for (uint16_t y = 0; y < LCD_HEIGHT; ++y) {
+        Display_RasterizeTemplateRow(spec, y, row);
+        for (uint16_t x = 0; x < LCD_WIDTH; ++x) {
+            if (count && (row[x] != color || count == UINT8_MAX)) {
+                if (out) { out[size] = count; out[size + 1] = color; }
+                size += 2;
+                count = 0;
+            }
+            color = row[x];
+            count++;
+        }
+    }
+    if (out) { out[size] = count; out[size + 1] = color; }
+    return size + 2;
+}
+
+// Encodes every screen's template into PSRAM. Screens that don't fit are drawn live.
+static void Display_BuildTemplateCache(void)
+{
+    for (size_t screen = 0; screen < ARRAY_LEN(screenSpecs); ++screen) {
+        TemplateCacheEntry* entry = &templateCache[screen];
+        if (entry->runs) continue;
+
+        size_t size = Display_EncodeTemplate(&screenSpecs[screen], NULL);
+        entry->runs = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!entry->runs) {
+            printf("Screen %u template: no PSRAM for %u bytes, drawing it live\n", (unsigned)screen, (unsigned)size);
+            continue;
+        }
+        entry->size = Display_EncodeTemplate(&screenSpecs[screen], entry->runs);
+        printf("Screen %u template: %u bytes in PSRAM (%u%% of %u)\n", (unsigned)screen, (unsigned)entry->size,
+               (unsigned)(entry->size * 100 / (LCD_WIDTH * LCD_HEIGHT)), (unsigned)(LCD_WIDTH * LCD_HEIGHT));
+    }
+}
 
+// Decodes a cached template block by block and streams it over the whole draw layer. False if the screen isn't cached or the stream failed.
+static bool Display_BlitTemplate(const ScreenSpec* spec)
+{
+    const TemplateCacheEntry* entry = &templateCache[spec - screenSpecs];
+    if (!entry->runs) return false;
+
+    const uint8_t* run = entry->runs;
+    const uint8_t* end = run + entry->size;
+    uint8_t count = 0, color = 0;
+    esp_err_t err = ESP_OK;
+
+    RA8875_blit_begin(&lcd, 0, 0, drawLayer, LCD_WIDTH, LCD_HEIGHT);
+    for (uint16_t y = 0; y < LCD_HEIGHT && err == ESP_OK; y += TEMPLATE_CACHE_ROWS) {
+        size_t len = sizeof(templateBlock);
+        if (y + TEMPLATE_CACHE_ROWS > LCD_HEIGHT) len = (LCD_HEIGHT - y) * LCD_WIDTH;
+
+        for (size_t i = 0; i < len; ) {
+            if (!count) {
+                if (run == end) break;
+                count = run[0];
+                color = run[1];
+                run += 2;
+            }
+            size_t n = (count < len - i) ? count : len - i;
+            memset(&templateBlock[i], color, n);
+            i += n;
+            count -= n;
+        }
+        err = RA8875_write_data_stream(&lcd, templateBlock, len);
+    }
+    RA8875_blit_end(&lcd);
+    return err == ESP_OK;
+}
+#else
+static bool Display_BlitTemplate(const ScreenSpec* spec)
+{
+    (void)spec;
+    return false;
+}
+#endif
+
+static void Display_FormatValue(const ValueSpec* slot, char* buffer, size_t size)
+{
+    const FieldValue* value = &fieldValues[slot->field];
+
+    switch (slot->format) {
+        case FORMAT_INT:
+            NumFmt_Float(buffer, size, value->number, 0);
+            break;
+        case FORMAT_FIXED2:
+            NumFmt_Float(buffer, size, value->number, 2);
+            break;
+        case FORMAT_FIXED5:
+            NumFmt_Float(buffer, size, value->number, 5);
+            break;
+        case FORMAT_STRING:
+            strncpy(buffer, value->text, size - 1);
+            buffer[size - 1] = '\0';
+            break;
+    }
+}
+
+// Value cells are fixed width in every font, so a changed character never moves its neighbours
+static uint16_t Display_CellWidth(DisplayFont_t font)
+{
+    switch (font) {
+        case DISPLAY_FONT_INTERNAL: return INTERNAL_CHAR_WIDTH;
+        case DISPLAY_FONT_SEGMENT:  return SEGMENT_CELL_WIDTH;
+        default:                    return GLYPH_CELL_WIDTH;
+    }
+}
+
+static uint16_t Display_CellHeight(DisplayFont_t font)
+{
+    switch (font) {
+        case DISPLAY_FONT_INTERNAL: return INTERNAL_CHAR_HEIGHT;
+        case DISPLAY_FONT_SEGMENT:  return SEGMENT_HEIGHT;
+        default:                    return GLYPH_HEIGHT;
+    }
+}
+
+static uint8_t Display_SegmentsFor(char ch)
+{
+    return ((uint8_t)ch < ARRAY_LEN(segmentsForChar)) ? segmentsForChar[(uint8_t)ch] : 0;
+}
+
+// Turns a digit shown as oldSegments into newSegments, drawing only the segments that flip. Expects graphic mode.
+static void Display_DrawSegmentDigit(uint16_t x, uint16_t y, uint8_t oldSegments, uint8_t newSegments, uint8_t bg)
+{
+    const uint8_t passes[2] = { oldSegments & ~newSegments, newSegments & ~oldSegments };  // Off, then on
+
+    for (uint8_t pass = 0; pass < 2; ++pass) {
+        for (uint8_t seg = 0; seg < ARRAY_LEN(segmentRects); ++seg) {
+            if (!(passes[pass] & (1 << seg))) continue;
+
+            const LineSpec* r = &segmentRects[seg];
+            Display_DrawRect(x + r->x1, y + r->y1, x + r->x2, y + r->y2, pass ? COLOR_WHITE : bg, true);
+        }
+    }
+}
+
+static void Display_WriteSegments(uint16_t x, uint16_t y, const char* msg)
+{
+    for (; *msg; msg++, x += SEGMENT_CELL_WIDTH) {
+        Display_DrawSegmentDigit(x, y, 0, Display_SegmentsFor(*msg), COLOR_BLACK);
+    }
+}
+
+// Finds the next run of set bits in cells from *start up to limit and returns where it ends (== *start when there's none left)
+static size_t Display_NextCellRun(uint16_t cells, size_t limit, size_t* start)
+{
+    while (*start < limit && !(cells & (1U << *start))) (*start)++;
+
+    size_t end = *start;
+    while (end < limit && (cells & (1U << end))) end++;
+    return end;
+}
+
+// What erased value cells are filled with: the slot background, or the key color when the chrome underneath provides it
+static uint8_t Display_ValueBackground(const ValueSpec* slot)
+{
+    return (DISPLAY_LAYER_MODE == LAYER_MODE_SPLIT) ? VALUE_KEY_COLOR : slot->bg;
+}
+
+static void Display_WriteCells(const ValueSpec* slot, size_t first, const char* text, size_t count)
+{
+    uint16_t x = slot->x + first * Display_CellWidth(slot->font);
+
+    if (slot->font == DISPLAY_FONT_INTERNAL) {
+        // The text engine advances exactly one cell per character, so a run needs one cursor move
+        Display_SetTextCursor(x, slot->y);
+        RA8875_write_command(&lcd, 0x02);
+        RA8875_write_data_stream(&lcd, (const uint8_t*)&text[first], count);
     } else {
-        Display_WriteNumberAt(350, 0   + VALUES_Y_OFFSET + 50, false, defaultFloat, false); // Pack %
-        Display_WriteNumberAt(350, 180 + VALUES_Y_OFFSET + 50, false, defaultFloat, false); // Distance Traveled
-        Display_WriteNumberAt(120, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // Torque Limit
-        Display_WriteNumberAt(390, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // TC Lat Mode
-        Display_WriteNumberAt(660, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // TV Balance
+        char ch[2] = {0};
+        for (size_t i = 0; i < count; ++i, x += GLYPH_CELL_WIDTH) {
+            ch[0] = text[first + i];
+            Display_WriteComicSans(x, slot->y, ch);
+        }
+    }
+}
+
+// Formats the value slots whose field is in fieldMask into text, one row per slot
+static void Display_FormatValues(const ScreenSpec* spec, uint32_t fieldMask, char text[][FIELD_TEXT_MAX])
+{
+    for (size_t i = 0; i < spec->valueCount; ++i) {
+        if (fieldMask & FIELD_BIT(spec->values[i].field)) {
+            Display_FormatValue(&spec->values[i], text[i], FIELD_TEXT_MAX);
+        }
     }
 }
 
-static void Display_RenderStaticDebugScreen()
+// Redraws the value slots whose field is in fieldMask from their Display_FormatValues text, touching only the character cells that differ from what's on screen.
+// Returns the number of glyphs left alone because they were already showing.
+static uint32_t Display_DrawValues(const ScreenSpec* spec, uint32_t fieldMask, char text[][FIELD_TEXT_MAX])
 {
-    Display_ResetState();
+    uint16_t changedCells[MAX_SCREEN_VALUES] = {0};  // Bit per character cell
+    uint32_t glyphsSaved = 0;
+    bool changed = false;
+
+    for (size_t i = 0; i < spec->valueCount; ++i) {
+        const ValueSpec* slot = &spec->values[i];
+        if (!(fieldMask & FIELD_BIT(slot->field))) continue;
+
+        const char* old = drawnValues[i];
+        size_t oldLen = strlen(old), newLen = strlen(text[i]);
+        size_t cells = (oldLen > newLen) ? oldLen : newLen;
+        for (size_t j = 0; j < cells; ++j) {
+            char oldCh = (j < oldLen) ? old[j] : '\0';
+            char newCh = (j < newLen) ? text[i][j] : '\0';
+            if (oldCh != newCh) {
+                changedCells[i] |= 1U << j;
+            } else {
+                glyphsSaved++;
+            }
+        }
+        if (!changedCells[i]) continue;
+
+        // Segment digits are plain rectangles, so they're diffed segment by segment and drawn right here in graphic mode
+        if (slot->font == DISPLAY_FONT_SEGMENT) {
+            Display_EnableDrawMode();
+            for (size_t j = 0; j < cells; ++j) {
+                if (!(changedCells[i] & (1U << j))) continue;
+                uint8_t oldSegments = (j < oldLen) ? Display_SegmentsFor(old[j]) : 0;
+                uint8_t newSegments = (j < newLen) ? Display_SegmentsFor(text[i][j]) : 0;
+                Display_DrawSegmentDigit(slot->x + j * SEGMENT_CELL_WIDTH, slot->y, oldSegments, newSegments, Display_ValueBackground(slot));
+            }
+            strcpy(drawnValues[i], text[i]);
+            changedCells[i] = 0;
+            continue;
+        }
+        changed = true;
+
+        // Erase everything first so the whole pass needs one switch to graphic mode and one back
+        uint16_t width = Display_CellWidth(slot->font), height = Display_CellHeight(slot->font);
+        for (size_t start = 0, end; (end = Display_NextCellRun(changedCells[i], oldLen, &start)) > start; start = end) {
+            Display_EnableDrawMode();
+            Display_DrawRect(slot->x + start * width, slot->y, slot->x + end * width - 1, slot->y + height - 1, Display_ValueBackground(slot), true);
+        }
+    }
+
+    if (!changed) return glyphsSaved;
+    RA8875_wait_idle(&lcd); // Erases have to finish before switching to text mode
+
+    const DisplayFont_t fonts[] = { DISPLAY_FONT_INTERNAL, DISPLAY_FONT_COMIC_SANS };
+    for (size_t f = 0; f < ARRAY_LEN(fonts); ++f) {
+        bool fontSet = false;
+
+        for (size_t i = 0; i < spec->valueCount; ++i) {
+            const ValueSpec* slot = &spec->values[i];
+            if (!changedCells[i] || slot->font != fonts[f]) continue;
+
+            if (!fontSet) {
+                Display_EnableTextModeAndFont(fonts[f]);
+                fontSet = true;
+            }
+            size_t newLen = strlen(text[i]);
+            for (size_t start = 0, end; (end = Display_NextCellRun(changedCells[i], newLen, &start)) > start; start = end) {
+                Display_WriteCells(slot, start, text[i], end - start);
+            }
+            strcpy(drawnValues[i], text[i]);
+        }
+    }
+    return glyphsSaved;
+}
+
+// Draws a screen's fills, borders and labels in immediate mode
+static void Display_DrawStatic(const ScreenSpec* spec)
+{
+    Display_EnableDrawMode();
+    Display_DrawFills(spec->fills, spec->fillCount);
+    Display_DrawBorders(spec->borders, spec->borderCount);
+    RA8875_wait_idle(&lcd); // Rectangles have to finish before switching to text mode
+    Display_DrawLabels(spec, DISPLAY_FONT_COMIC_SANS);
+    Display_DrawLabels(spec, DISPLAY_FONT_INTERNAL);
+}
+
+#if DISPLAY_LISTS
+static void Display_ListAppend(uint8_t kind, uint8_t arg, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, const char* text)
+{
+    DisplayList* list = recordingList;
+    if (list->count == DISPLAY_LIST_MAX) {
+        list->valid = false;
+        return;
+    }
+    list->ops[list->count++] = (DisplayOp){ kind, arg, x1, y1, x2, y2, text };
+}
+
+static void Display_ListRemove(DisplayList* list, size_t i)
+{
+    memmove(&list->ops[i], &list->ops[i + 1], (list->count - i - 1) * sizeof(DisplayOp));
+    list->count--;
+}
+
+static bool Display_OpsOverlap(const DisplayOp* a, const DisplayOp* b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+// Whether drawing a and b in either order gives the same pixels: they don't overlap, or they draw the same color (all text is white)
+static bool Display_OpsCommute(const DisplayOp* a, const DisplayOp* b)
+{
+    if (!Display_OpsOverlap(a, b)) return true;
+    return a->kind == b->kind && (a->kind == DISPLAY_OP_TEXT || a->arg == b->arg);
+}
+
+// Whether op j can move back to position i, past everything drawn between them
+static bool Display_ListCanHoist(const DisplayList* list, size_t i, size_t j)
+{
+    for (size_t k = i + 1; k < j; ++k) {
+        if (!Display_OpsCommute(&list->ops[k], &list->ops[j])) return false;
+    }
+    return true;
+}
+
+// Merges two same-color rectangles into a when together they cover exactly one rectangle
+static bool Display_MergeRects(DisplayOp* a, const DisplayOp* b)
+{
+    bool sameRows = a->y1 == b->y1 && a->y2 == b->y2 && a->x1 <= b->x2 + 1 && b->x1 <= a->x2 + 1;
+    bool sameCols = a->x1 == b->x1 && a->x2 == b->x2 && a->y1 <= b->y2 + 1 && b->y1 <= a->y2 + 1;
+    bool aHoldsB = a->x1 <= b->x1 && a->x2 >= b->x2 && a->y1 <= b->y1 && a->y2 >= b->y2;
+    bool bHoldsA = b->x1 <= a->x1 && b->x2 >= a->x2 && b->y1 <= a->y1 && b->y2 >= a->y2;
+    if (!sameRows && !sameCols && !aHoldsB && !bHoldsA) return false;
+
+    if (b->x1 < a->x1) a->x1 = b->x1;
+    if (b->y1 < a->y1) a->y1 = b->y1;
+    if (b->x2 > a->x2) a->x2 = b->x2;
+    if (b->y2 > a->y2) a->y2 = b->y2;
+    return true;
+}
+
+// Coordinate register bytes two rectangles have in common. Drawn back to back, the shadow skips writing those for the second.
+static int Display_SharedCoordinateBytes(const DisplayOp* a, const DisplayOp* b)
+{
+    const uint16_t ca[4] = { a->x1, a->y1, a->x2, a->y2 };
+    const uint16_t cb[4] = { b->x1, b->y1, b->x2, b->y2 };
+    int shared = 0;
+    for (int i = 0; i < 4; ++i) {
+        shared += ((ca[i] & 0xFF) == (cb[i] & 0xFF)) + ((ca[i] >> 8) == (cb[i] >> 8));
+    }
+    return shared;
+}
+
+// Drops draws a later rectangle paints over, merges same-color rectangles, then orders the draws so mode and color change as rarely as possible
+static void Display_OptimizeList(DisplayList* list)
+{
+    // Dead draws: anything entirely inside a later rectangle
+    for (size_t i = 0; i < list->count; ) {
+        bool dead = false;
+        for (size_t j = i + 1; j < list->count && !dead; ++j) {
+            const DisplayOp* cover = &list->ops[j];
+            const DisplayOp* op = &list->ops[i];
+            dead = cover->kind == DISPLAY_OP_RECT && cover->x1 <= op->x1 && cover->x2 >= op->x2 && cover->y1 <= op->y1 && cover->y2 >= op->y2;
+        }
+        if (dead) {
+            Display_ListRemove(list, i);
+        } else {
+            ++i;
+        }
+    }
+
+    // Merges, until none are left
+    for (bool merged = true; merged; ) {
+        merged = false;
+        for (size_t i = 0; i < list->count && !merged; ++i) {
+            for (size_t j = i + 1; j < list->count && !merged; ++j) {
+                DisplayOp* a = &list->ops[i];
+                const DisplayOp* b = &list->ops[j];
+                if (a->kind != DISPLAY_OP_RECT || b->kind != DISPLAY_OP_RECT || a->arg != b->arg) continue;
+                if (!Display_ListCanHoist(list, i, j) || !Display_MergeRects(a, b)) continue;
+                Display_ListRemove(list, j);
+                merged = true;
+            }
+        }
+    }
+
+    // Ordering: repeatedly take a draw with nothing undrawn before it that it doesn't commute with,
+    // preferring the same mode and color (or font) as the last one, then the same mode, then the earliest.
+    // Among rectangles of the same color, the one sharing the most coordinate bytes with the last wins. Text cursors are always written, so text has no such tiebreak.
+    DisplayOp sorted[DISPLAY_LIST_MAX];
+    bool taken[DISPLAY_LIST_MAX] = {false};
+    const DisplayOp* last = NULL;
+    for (size_t n = 0; n < list->count; ++n) {
+        int pick = -1, pickScore = -1;
+        for (size_t i = 0; i < list->count; ++i) {
+            if (taken[i]) continue;
+
+            bool ready = true;
+            for (size_t k = 0; k < i && ready; ++k) {
+                ready = taken[k] || Display_OpsCommute(&list->ops[k], &list->ops[i]);
+            }
+            if (!ready) continue;
+
+            const DisplayOp* op = &list->ops[i];
+            int score = !last ? 0 : (op->kind != last->kind) ? 0 : (op->arg != last->arg) ? 1 : 2;
+            score *= 16;
+            if (last && op->kind == DISPLAY_OP_RECT && last->kind == DISPLAY_OP_RECT) score += Display_SharedCoordinateBytes(last, op);
+            if (score > pickScore) {
+                pick = (int)i;
+                pickScore = score;
+            }
+        }
+        sorted[n] = list->ops[pick];
+        taken[pick] = true;
+        last = &list->ops[pick];
+    }
+    memcpy(list->ops, sorted, list->count * sizeof(DisplayOp));
+}
+
+// Records every screen's static draws through the normal drawing calls, then optimizes each list
+static void Display_BuildDisplayLists(void)
+{
+    for (size_t screen = 0; screen < ARRAY_LEN(screenSpecs); ++screen) {
+        DisplayList* list = &displayLists[screen];
+        list->count = 0;
+        list->valid = true;
+
+        recordingList = list;
+        Display_DrawStatic(&screenSpecs[screen]);
+        recordingList = NULL;
+
+        list->recorded = list->count;
+        if (!list->valid) {
+            printf("Screen %u display list: over %d draws, drawing it immediately\n", (unsigned)screen, DISPLAY_LIST_MAX);
+            continue;
+        }
+        Display_OptimizeList(list);
+        printf("Screen %u display list: %u draws recorded, %u after optimizing\n", (unsigned)screen, list->recorded, list->count);
+    }
+}
+
+// Sends a screen's optimized static draws. False if it has no list.
+static bool Display_ReplayList(const ScreenSpec* spec)
+{
+    const DisplayList* list = &displayLists[spec - screenSpecs];
+    if (!list->valid) return false;
+
+    int font = -2;  // Text font set up, -1 in graphic mode for rectangles, -2 before the first draw
+    size_t texts = 0;
+    for (size_t i = 0; i < list->count; ++i) {
+        const DisplayOp* op = &list->ops[i];
+        if (op->kind == DISPLAY_OP_RECT) {
+            if (font != -1) {
+                Display_EnableDrawMode();
+                font = -1;
+            }
+            Display_DrawRect(op->x1, op->y1, op->x2, op->y2, op->arg, true);
+            continue;
+        }
+
+        if (op->arg != font) {
+            RA8875_wait_idle(&lcd); // Rectangles have to finish before switching to text mode
+            Display_EnableTextModeAndFont((DisplayFont_t)op->arg);
+            font = op->arg;
+        }
+        Display_WriteTextAt(op->x1, op->y1, op->text);
+        if (++texts % LABELS_PER_WATCHDOG_FEED == 0) {
+            vTaskDelay(pdMS_TO_TICKS(WATCHDOG_DELAY));
+        }
+    }
+    return true;
+}
+#else
+static bool Display_ReplayList(const ScreenSpec* spec)
+{
+    (void)spec;
+    return false;
+}
+#endif
+
+#if DISPLAY_LAYER_MODE != LAYER_MODE_SPLIT
+static void Display_RenderScreen(const ScreenSpec* spec)
+{
+    // The template copy paints every row above TEMPLATE_HEIGHT, so only the strip below it needs clearing
+#if DISPLAY_LAYER_MODE == LAYER_MODE_OFFSCREEN
+    bool useTemplate = spec == templateSpec;
+#else
+    bool useTemplate = false;  // The second layer is a page, so there's no template
+#endif
+    memset(drawnValues, 0, sizeof(drawnPages[0]));
+
+    // Otherwise a cached template covers the whole screen, clear included, and only the internal-font labels and values are left to draw
+    if (!useTemplate && Display_BlitTemplate(spec)) {
+        char text[MAX_SCREEN_VALUES][FIELD_TEXT_MAX];
+        Display_SetTextCursor(0, 0);
+        Display_FormatValues(spec, FIELD_MASK_ALL, text);
+        Display_DrawLabels(spec, DISPLAY_FONT_INTERNAL);
+        Display_DrawValues(spec, FIELD_MASK_ALL, text);
+        return;
+    }
+    Display_ResetState(useTemplate ? TEMPLATE_HEIGHT : 0, LCD_HEIGHT - 1);
 
     // =======================
     // ====== DRAWINGS =======
     // ======================= 
 
-    Display_EnableDrawMode();
+    // Format the values while the template copy runs; it only has to finish before the next write
+    char text[MAX_SCREEN_VALUES][FIELD_TEXT_MAX];
+    RA8875_bte_handle_t templateCopy = 0;
+    if (useTemplate) {
+        templateCopy = RA8875_bte_move_async(&lcd, 0, 0, LAYER_OFFSCREEN, 0, 0, LAYER_DISPLAY, LCD_WIDTH, TEMPLATE_HEIGHT, 0, 0xC, NULL, NULL);
+    }
+    Display_FormatValues(spec, FIELD_MASK_ALL, text);
 
-    // White Borders in Debug Screen
-    Display_DrawBorders(debugBordersNoRTD, ARRAY_LEN(debugBordersNoRTD));
+    // If the template copy times out, draw everything live instead
+    bool prerendered = useTemplate && RA8875_bte_wait(&lcd, templateCopy) == ESP_OK;
+    if (useTemplate && !prerendered) {
+        RA8875_clear_region(&lcd, 0, 0, LCD_WIDTH - 1, TEMPLATE_HEIGHT - 1, LAYER_DISPLAY, COLOR_BLACK);
+    }
 
+    // The template holds the fills and Comic Sans labels; otherwise everything static comes from the display list, or is drawn immediately
+    if (prerendered) {
+        Display_EnableDrawMode();
+        Display_DrawBorders(spec->borders, spec->borderCount);
+        RA8875_wait_idle(&lcd); // Rectangles have to finish before switching to text mode
+        Display_DrawLabels(spec, DISPLAY_FONT_INTERNAL);
+    } else if (!Display_ReplayList(spec)) {
+        Display_DrawStatic(spec);
+    }
 
     // =======================
     // ======== TEXT =========
     // ======================= 
-    
-    // Text Labels 
-    Display_EnableTextModeAndFont(DISPLAY_FONT_COMIC_SANS); 
-
-    Display_WriteTextAt(20,  0   + LABELS_Y_OFFSET, "LV Voltage");
-    Display_WriteTextAt(240, 0   + LABELS_Y_OFFSET, "GPS Long");
-    Display_WriteTextAt(450, 0   + LABELS_Y_OFFSET, "GPS Lat");
-    Display_WriteTextAt(615, 0   + LABELS_Y_OFFSET, "Pack Voltage");
-    Display_WriteTextAt(20,   120 + LABELS_Y_OFFSET, "Motor T Max"); 
-    Display_WriteTextAt(240, 120 + LABELS_Y_OFFSET, "APP Arb");
-    Display_WriteTextAt(400, 120 + LABELS_Y_OFFSET, "Torque Rq Avg");
-    Display_WriteTextAt(650, 120 + LABELS_Y_OFFSET, "Rotor T");
-    vTaskDelay(pdMS_TO_TICKS(WATCHDOG_DELAY));
-    Display_WriteTextAt(30,  240 + LABELS_Y_OFFSET, "Inv T Max"); 
-    Display_WriteTextAt(220, 240 + LABELS_Y_OFFSET, "Steer Angle");
-    Display_WriteTextAt(410, 240 + LABELS_Y_OFFSET, "F Brake Bias");
-    Display_WriteTextAt(650, 240 + LABELS_Y_OFFSET, "Logging");
-    Display_WriteTextAt(20,  360 + LABELS_Y_OFFSET, "Min Cell V"); 
-    Display_WriteTextAt(220, 360 + LABELS_Y_OFFSET, "Peak Cell T");
-    Display_WriteTextAt(405, 360 + LABELS_Y_OFFSET, "F Brake Press");
-    Display_WriteTextAt(620, 360 + LABELS_Y_OFFSET, "Power Limit");
-    
-    // Text Values
-    float defaultFloat = 0;
-    int defaultInt = 0;
-    char* defaultString = "RR";
-    
-    Display_EnableTextModeAndFont(DISPLAY_FONT_INTERNAL);  
-
-    Display_WriteNumberAt(50,  0   + VALUES_Y_OFFSET, false, defaultFloat, false); // LV Voltage   
-    Display_WriteNumberAt(215, 0   + VALUES_Y_OFFSET, false, defaultFloat, true); // GPS Long (many digits)
-    Display_WriteNumberAt(415, 0   + VALUES_Y_OFFSET, false, defaultFloat, true); // GPS Lat (many digits)
-    Display_WriteNumberAt(650, 0   + VALUES_Y_OFFSET, false, defaultFloat, false); // Pack Voltage 
-    Display_WriteNumberAt(40,  120 + VALUES_Y_OFFSET, true, defaultInt, false); // Motor Temp Max + corner
-    Display_WriteTextAt(  80,  120 + VALUES_Y_OFFSET, defaultString);
-    Display_WriteNumberAt(250, 120 + VALUES_Y_OFFSET, false, defaultFloat, false); // APP Arb
-    Display_WriteNumberAt(450, 120 + VALUES_Y_OFFSET, false, defaultFloat, false); // Torque Req Avg
-    Display_WriteNumberAt(690, 120 + VALUES_Y_OFFSET, true, defaultInt, false); // Rotor Temp
-    Display_WriteNumberAt(40,  240 + VALUES_Y_OFFSET, true, defaultInt, false); // Inverter temp max + corner
-    Display_WriteTextAt(  80,  240 + VALUES_Y_OFFSET, defaultString);
-    Display_WriteNumberAt(250, 240 + VALUES_Y_OFFSET, false, defaultFloat, false); // Steer Angle
-    Display_WriteNumberAt(450, 240 + VALUES_Y_OFFSET, false, defaultFloat, false); // Front Brake Bias
-    Display_WriteNumberAt(690, 240 + VALUES_Y_OFFSET, true, defaultInt, false); // Logging
-    Display_WriteNumberAt(30,  360 + VALUES_Y_OFFSET, true, defaultInt, false); // Min Cell V + index
-    Display_WriteTextAt(  50,  360 + VALUES_Y_OFFSET, ",i="); 
-    Display_WriteNumberAt(120, 360 + VALUES_Y_OFFSET, true, defaultInt, false); 
-    Display_WriteNumberAt(230, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // Peak Cell T + index
-    Display_WriteTextAt(  250, 360 + VALUES_Y_OFFSET, ",i="); 
-    Display_WriteNumberAt(320, 360 + VALUES_Y_OFFSET, true, defaultInt, false); 
-    Display_WriteNumberAt(450, 360 + VALUES_Y_OFFSET, false, defaultFloat, false); // Front Brake Pressure
-    Display_WriteNumberAt(690, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // Power Limit
-}
-
-static void Display_PrerenderDebugRTDLabels(void) 
-{
-    Display_ResetState();
-    Display_EnableDrawMode();
-    Display_DrawRect(200, 170, 600, 240, COLOR_RED, true);
-
-    // (Excluded from prerender) loading box
-    Display_DrawRect(0, 415, 800, 480, COLOR_YELLOW, true);
 
-    vTaskDelay(pdMS_TO_TICKS(DEFAULT_DELAY));
+    Display_DrawValues(spec, FIELD_MASK_ALL, text);
+}
+#else
+// Paints the chrome layer once for the screen, then the values on a cleared value layer. Value updates after this only touch the value layer.
+static void Display_RenderSplitScreen(const ScreenSpec* spec)
+{
+    Display_SetDrawLayer(LAYER_CHROME);
+    if (Display_BlitTemplate(spec)) {
+        Display_SetTextCursor(0, 0);
+        Display_DrawLabels(spec, DISPLAY_FONT_INTERNAL);
+    } else {
+        Display_ResetState(0, LCD_HEIGHT - 1);
+        if (!Display_ReplayList(spec)) Display_DrawStatic(spec);
+    }
 
-    // (Excluded from prerender) Loading text: Internal font, blue text, smaller font
-    Display_EnableTextModeAndFont(DISPLAY_FONT_INTERNAL);
-    Display_InternalFontSize(FONT_SIZE_DOUBLE);
-    RA8875_write_register(&lcd, RA8875_REG_FG_R, 0x00); 
-    RA8875_write_register(&lcd, RA8875_REG_FG_G, 0x00);
-    RA8875_write_register(&lcd, RA8875_REG_FG_B, 0x03); 
-    Display_WriteTextAt(40,  430, "<<< PLEASE WAIT >>>     Loading Cumic Sans... "); 
+    Display_SetDrawLayer(LAYER_VALUES);
+    RA8875_clear_region(&lcd, 0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1, LAYER_VALUES, VALUE_KEY_COLOR);
+    Display_SetTextCursor(0, 0);
+    memset(drawnValues, 0, sizeof(drawnPages[0]));
 
-    Display_EnableTextModeAndFont(DISPLAY_FONT_COMIC_SANS); 
-    Display_WriteTextAt(20,  0   + LABELS_Y_OFFSET, "LV Voltage");
-    Display_WriteTextAt(305, 0   + LABELS_Y_OFFSET, "Last Lap Time");
-    Display_WriteTextAt(610, 0   + LABELS_Y_OFFSET, "Pack Voltage");
-    Display_WriteTextAt(10,  120 + LABELS_Y_OFFSET, "Motor T Max"); 
-    Display_WriteTextAt(355, 120 + LABELS_Y_OFFSET, "Pack %");
-    Display_WriteTextAt(650, 120 + LABELS_Y_OFFSET, "Rotor T");
-    Display_WriteTextAt(30,  240 + LABELS_Y_OFFSET, "Inv T Max"); 
-    vTaskDelay(pdMS_TO_TICKS(WATCHDOG_DELAY));
-    Display_WriteTextAt(380, 240 + LABELS_Y_OFFSET, "Lap");
-    Display_WriteTextAt(610, 240 + LABELS_Y_OFFSET, "Torque Limit"); // No coloring/warning
-    Display_WriteTextAt(20,  360 + LABELS_Y_OFFSET, "Min Cell V"); 
-    Display_WriteTextAt(220, 360 + LABELS_Y_OFFSET, "Peak Cell T");
-    Display_WriteTextAt(405, 360 + LABELS_Y_OFFSET, "F Brake Press");
-    Display_WriteTextAt(640, 360 + LABELS_Y_OFFSET, "TC");
-    Display_WriteTextAt(740, 360 + LABELS_Y_OFFSET, "TV");
-    RA8875_bte_move(&lcd, 0, 0, LAYER_DISPLAY, 0, 0, LAYER_OFFSCREEN, 800, 400, 0, 0xC);  // Save to off-screen, ignore lower part
+    char text[MAX_SCREEN_VALUES][FIELD_TEXT_MAX];
+    Display_FormatValues(spec, FIELD_MASK_ALL, text);
+    Display_DrawValues(spec, FIELD_MASK_ALL, text);
 }
+#endif
 
-static void Display_UsePrerenderedDebugRTD()
+#if DISPLAY_LAYER_MODE == LAYER_MODE_OFFSCREEN
+// Draws a screen's fills and Comic Sans labels into the template rows of the off-screen layer, for Display_RenderScreen to copy in.
+// The active window keeps everything above the atlas, and the visible layer isn't touched, so this can run while another screen shows.
+static void Display_PrerenderTemplate(const ScreenSpec* spec) 
 {
-    Display_ResetState();
-
-    RA8875_bte_move(&lcd, 0, 0, LAYER_OFFSCREEN, 0, 0, LAYER_DISPLAY, 800, 400, 0, 0xC);
+    templateSpec = NULL;  // Half-drawn until the end
+    RA8875_clear_region(&lcd, 0, 0, LCD_WIDTH - 1, TEMPLATE_HEIGHT - 1, LAYER_OFFSCREEN, COLOR_BLACK);
+    Display_SetDrawLayer(LAYER_OFFSCREEN);
+    RA8875_set_active_window(&lcd, 0, 0, LCD_WIDTH - 1, TEMPLATE_HEIGHT - 1);
 
     Display_EnableDrawMode();
-    Display_DrawBorders(debugBordersRTD, ARRAY_LEN(debugBordersRTD));
-
-    float defaultFloat = 0.0;
-    int defaultInt = 0;
-    char* defaultString = "RR";
-    Display_EnableTextModeAndFont(DISPLAY_FONT_INTERNAL);  
-    Display_WriteNumberAt(50,  0   + VALUES_Y_OFFSET, false, defaultFloat, false); // LV Voltage   
-    Display_WriteNumberAt(355, 0   + VALUES_Y_OFFSET, false, defaultFloat, false); // Last Lap Time  
-    Display_WriteNumberAt(655, 0   + VALUES_Y_OFFSET, false, defaultFloat, false); // Pack Voltage 
-    Display_WriteNumberAt(50,  120 + VALUES_Y_OFFSET, true, defaultInt, false); // Motor Temp Max + corner
-    Display_WriteTextAt(  90,  120 + VALUES_Y_OFFSET, defaultString);
-    Display_WriteNumberAt(355, 120 + VALUES_Y_OFFSET, false, defaultFloat, false); // Pack % 
-    Display_WriteNumberAt(690, 120 + VALUES_Y_OFFSET, true, defaultInt, false); // Rotor Temp
-    Display_WriteNumberAt(50,  240 + VALUES_Y_OFFSET, true, defaultInt, false); // Inverter temp max + corner
-    Display_WriteTextAt(  90,  240 + VALUES_Y_OFFSET, defaultString);
-    Display_WriteNumberAt(390, 240 + VALUES_Y_OFFSET, true, defaultInt, false); // Lap Num
-    Display_WriteNumberAt(690, 240 + VALUES_Y_OFFSET, true, defaultInt, false); // Torque Limit
-    Display_WriteNumberAt(20,  360 + VALUES_Y_OFFSET, true, defaultInt, false); // Min Cell V + index
-    Display_WriteTextAt(  40,  360 + VALUES_Y_OFFSET, ",i="); 
-    Display_WriteNumberAt(120, 360 + VALUES_Y_OFFSET, true, defaultInt, false); 
-    Display_WriteNumberAt(220, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // Peak Cell T + index
-    Display_WriteTextAt(  240, 360 + VALUES_Y_OFFSET, ",i="); 
-    Display_WriteNumberAt(320, 360 + VALUES_Y_OFFSET, true, defaultInt, false); 
-    Display_WriteNumberAt(455, 360 + VALUES_Y_OFFSET, false, defaultFloat, false); // Front Brake Pressure
-    Display_WriteNumberAt(640, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // TC Mode
-    Display_WriteNumberAt(740, 360 + VALUES_Y_OFFSET, true, defaultInt, false); // TV Balance
+    Display_DrawFills(spec->fills, spec->fillCount);
+    RA8875_wait_idle(&lcd); // Rectangles have to finish before switching to text mode
+    Display_DrawLabels(spec, DISPLAY_FONT_COMIC_SANS);
+
+    RA8875_reset_active_window(&lcd);
+    Display_SetDrawLayer(LAYER_DISPLAY);
+    templateSpec = spec;
 }
+#endif
 
-static void Display_Warn() 
+static const ScreenSpec* Display_CurrentSpec(void)
+{
+    if (CURRENT_SCREEN >= ARRAY_LEN(screenSpecs)) return NULL;
+    return &screenSpecs[CURRENT_SCREEN];
+}
+
+// Draws a red warning on the draw layer, full screen or as a banner across the top. Whatever is outside the banner is left alone.
+static void Display_DrawWarning(const char* text, bool fullScreen)
 {
-    Display_ResetState();
     Display_EnableDrawMode();
-    Display_DrawRect(0, 0, 800, 480, COLOR_RED, true);
-    vTaskDelay(pdMS_TO_TICKS(DEFAULT_DELAY));
+    Display_DrawRect(0, 0, 800, fullScreen ? 480 : OVERLAY_BANNER_HEIGHT, COLOR_RED, true);
+    RA8875_wait_idle(&lcd); // Rectangles have to finish before switching to text mode
     Display_EnableTextModeAndFont(DISPLAY_FONT_INTERNAL);
     Display_InternalFontSize(FONT_SIZE_QUADRUPLE);
     Display_ForegroundWhite();
-    Display_WriteTextAt(290, 200, "WARNING");
+
+    uint16_t width = strlen(text) * INTERNAL_CHAR_WIDTH * 4 / 3;
+    uint16_t height = INTERNAL_CHAR_HEIGHT * 4 / 3;
+    uint16_t x = width < LCD_WIDTH ? (LCD_WIDTH - width) / 2 : 0;
+    uint16_t y = fullScreen ? 200 : (OVERLAY_BANNER_HEIGHT - height) / 2;
+    Display_WriteTextAt(x, y, text);
 }
 
-void Display_Init(void) 
+static void Display_Warn() 
+{
+    Display_DrawWarning("WARNING", true);
+}
+
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+// Mixes the overlay page over the screen page, or shows the screen page alone. One register write either way.
+static void Display_ShowOverlay(bool shown)
+{
+    overlayShown = shown;
+    RA8875_set_layer_transparency(&lcd, 0, 0, shown ? RA8875_LAYER_LIGHTEN : visiblePage);
+}
+
+// Draws the raised warning on the page the screen isn't using and mixes it in
+static void Display_DrawOverlayPage(void)
+{
+    uint8_t page = visiblePage ^ 1;
+    Display_SetDrawLayer(page);
+    pageScreen[page] = -1;  // Holds the overlay now, so the next screen switch draws it in full
+    Display_ResetState(0, LCD_HEIGHT - 1);  // Black around the banner, so the screen shows through unmixed
+    Display_DrawWarning(overlayText, overlayFullScreen);
+    RA8875_wait_idle(&lcd);
+    Display_SetDrawLayer(visiblePage);  // Value updates keep going to the screen underneath
+
+    if (visiblePage == 0) {
+        RA8875_set_layer_mix(&lcd, OVERLAY_SCREEN_LEVEL, OVERLAY_LEVEL);
+    } else {
+        RA8875_set_layer_mix(&lcd, OVERLAY_LEVEL, OVERLAY_SCREEN_LEVEL);
+    }
+    Display_ShowOverlay(true);
+}
+#endif
+
+// Draws a screen from scratch, false if there's nothing to draw for it
+static bool Display_Render(Screen_t screen)
+{
+    if (screen != SCREEN_WARN && screen >= ARRAY_LEN(screenSpecs)) return false;
+
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    // Draw on the hidden page. If it already holds this screen, only the values that changed since need repainting.
+    // While a warning overlay is up the hidden page is mixed in, so draw in place under it instead.
+    uint8_t page = overlayRaised ? visiblePage : visiblePage ^ 1;
+    Display_SetDrawLayer(page);
+    if (pageScreen[page] == (int)screen) {
+        if (screen != SCREEN_WARN) {
+            const ScreenSpec* spec = &screenSpecs[screen];
+            char text[MAX_SCREEN_VALUES][FIELD_TEXT_MAX];
+            Display_FormatValues(spec, FIELD_MASK_ALL, text);
+            Display_DrawValues(spec, FIELD_MASK_ALL, text);
+        }
+    } else {
+        pageScreen[page] = screen;
+#endif
+        if (screen == SCREEN_WARN) {
+            Display_Warn();
+        } else {
+#if DISPLAY_LAYER_MODE == LAYER_MODE_SPLIT
+            Display_RenderSplitScreen(&screenSpecs[screen]);
+#else
+            Display_RenderScreen(&screenSpecs[screen]);
+#endif
+        }
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    }
+
+    // Nothing half-drawn may show, then the flip itself is one register write
+    if (page != visiblePage) {
+        RA8875_wait_idle(&lcd);
+        RA8875_set_layer_transparency(&lcd, 0, 0, page); // Display mode 0 shows only layer 1, 1 only layer 2
+        visiblePage = page;
+    }
+#else
+    if (overlayRaised) Display_DrawWarning(overlayText, overlayFullScreen);  // Drawn over the screen, see Display_RaiseWarning
+#endif
+    return true;
+}
+
+static void Display_Configure(void)
 {
-    RA8875_init(&lcd, LCD_SPI_HOST, LCD_SPI_SPEED, LCD_PIN_MOSI, LCD_PIN_MISO,
-                LCD_PIN_SCLK, LCD_PIN_CS, LCD_PIN_INT);    
     RA8875_configure(&lcd, 
                     LCD_HSYNC_NONDISP, LCD_HSYNC_START, LCD_HSYNC_PW, LCD_HSYNC_FINETUNE,
                     LCD_VSYNC_NONDISP, LCD_VSYNC_START, LCD_VSYNC_PW,
                     LCD_WIDTH, LCD_HEIGHT, LCD_VOFFSET);
+}
+
+#if BENCHMARK_CLEARS
+// Times a full-layer clear against clearing only each screen's value slots, with memory clears and with BTE fills
+static void Display_BenchmarkClears(void)
+{
+    for (size_t screen = 0; screen < ARRAY_LEN(screenSpecs); ++screen) {
+        const ScreenSpec* spec = &screenSpecs[screen];
+        if (!spec->valueCount) continue;
+
+        int64_t start = esp_timer_get_time();
+        RA8875_clear(&lcd);
+        RA8875_wait_idle(&lcd);
+        int64_t fullUs = esp_timer_get_time() - start;
+
+        int64_t regionUs[2];
+        for (int useFill = 0; useFill < 2; ++useFill) {
+            start = esp_timer_get_time();
+            for (size_t i = 0; i < spec->valueCount; ++i) {
+                const ValueSpec* slot = &spec->values[i];
+                uint16_t width = (FIELD_TEXT_MAX - 1) * Display_CellWidth(slot->font);
+                uint16_t height = Display_CellHeight(slot->font);
+                if (width > LCD_WIDTH - slot->x) width = LCD_WIDTH - slot->x;
+
+                if (useFill) {
+                    RA8875_bte_fill(&lcd, slot->x, slot->y, LAYER_DISPLAY, width, height, COLOR_BLACK);
+                } else {
+                    RA8875_clear_region(&lcd, slot->x, slot->y, slot->x + width - 1, slot->y + height - 1, LAYER_DISPLAY, COLOR_BLACK);
+                }
+            }
+            RA8875_wait_idle(&lcd);
+            regionUs[useFill] = esp_timer_get_time() - start;
+        }
+
+        printf("Screen %u clear: full layer %" PRId64 " us, %u value slots %" PRId64 " us (memory clear) / %" PRId64 " us (BTE fill)\n",
+               (unsigned)screen, fullUs, (unsigned)spec->valueCount, regionUs[0], regionUs[1]);
+    }
+}
+#endif
+
+#if TEMPLATE_CACHE && BENCHMARK_TEMPLATE_CACHE
+// Times rendering every screen live against rendering it from the template cache
+static void Display_BenchmarkTemplateCache(void)
+{
+    for (size_t screen = 0; screen < ARRAY_LEN(screenSpecs); ++screen) {
+        TemplateCacheEntry cached = templateCache[screen];
+        if (!cached.runs) continue;
+
+        int64_t us[2];
+        for (int useCache = 0; useCache < 2; ++useCache) {
+            templateCache[screen].runs = useCache ? cached.runs : NULL;
+            int64_t start = esp_timer_get_time();
+            Display_Render((Screen_t)screen);
+            RA8875_wait_idle(&lcd);
+            us[useCache] = esp_timer_get_time() - start;
+        }
+
+        printf("Screen %u render: live %" PRId64 " us, template cache %" PRId64 " us (%u bytes)\n",
+               (unsigned)screen, us[0], us[1], (unsigned)cached.size);
+    }
+}
+#endif
+
+#if DISPLAY_LISTS && BENCHMARK_DISPLAY_LISTS
+// Counts the SPI bytes of every screen's static draws in immediate mode and replayed from its display list
+static void Display_BenchmarkDisplayLists(void)
+{
+    for (size_t screen = 0; screen < ARRAY_LEN(screenSpecs); ++screen) {
+        const ScreenSpec* spec = &screenSpecs[screen];
+        if (!displayLists[screen].valid) continue;
+
+        uint32_t bytes[2];
+        for (int useList = 0; useList < 2; ++useList) {
+            RA8875_clear(&lcd);
+            RA8875_invalidate_shadow(&lcd);  // Both start with every register going out
+            RA8875_reset_bytes_written(&lcd);
+            if (useList) {
+                Display_ReplayList(spec);
+            } else {
+                Display_DrawStatic(spec);
+            }
+            bytes[useList] = RA8875_get_bytes_written(&lcd);
+        }
+
+        printf("Screen %u static draws: %" PRIu32 " SPI bytes immediate, %" PRIu32 " from the display list\n", (unsigned)screen, bytes[0], bytes[1]);
+    }
+}
+#endif
+
+// Everything after configuration: clear, backlight, fonts, layer setup, then the given screen
+static void Display_Start(Screen_t screen)
+{
     RA8875_clear(&lcd);
     RA8875_set_backlight_brightness(&lcd, LCD_BRIGHTNESS_100_PCT); 
     Display_SetTextCursor(0, 0);
-    Display_PrecomputeGlyphs();
-    Display_PrerenderDebugRTDLabels();
-    Display_SwitchScreen(SCREEN_DEBUG_NO_RTD);
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_CGRAM
+    Display_UploadComicSans();
+#elif COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_ATLAS
+    Display_AtlasInit();
+#endif
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    // After a recovery neither page can be trusted; show the freshly cleared one and draw on the other
+    pageScreen[0] = pageScreen[1] = -1;
+    visiblePage = LAYER_DISPLAY;
+    RA8875_set_layer_transparency(&lcd, 0, 0, visiblePage);
+#elif DISPLAY_LAYER_MODE == LAYER_MODE_SPLIT
+    // The value layer shows on top wherever it isn't the key color
+    RA8875_set_transparent_color(&lcd, VALUE_KEY_COLOR);
+    RA8875_set_layer_transparency(&lcd, 0, 0, RA8875_LAYER_TRANSPARENT);
+#else
+    templateSpec = NULL;
+#endif
+    predictionPending = true;  // Whatever was prerendered is gone, so do it again
+    Display_Render(screen);
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    if (overlayRaised) Display_DrawOverlayPage();
+#endif
+}
+
+void Display_Init(void) 
+{
+    RA8875_init(&lcd, LCD_SPI_HOST, LCD_SPI_SPEED, LCD_PIN_MOSI, LCD_PIN_MISO,
+                LCD_PIN_SCLK, LCD_PIN_CS, LCD_PIN_INT);    
+    RA8875_set_async(&lcd, 1); // Queue register writes back-to-back instead of waiting on each one
+    Display_Configure();
+
+    // With the PLL running, find how fast writes can go on this wiring. Configure again at that speed in case a failed probe hit another register.
+    int writeSpeed = RA8875_calibrate_write_speed(&lcd, LCD_SPI_MAX_WRITE_SPEED);
+    printf("SPI write clock %d Hz (%dx the %d Hz read clock)\n", writeSpeed, writeSpeed / LCD_SPI_SPEED, LCD_SPI_SPEED);
+#if BENCHMARK_REGISTER_WRITES
+    RA8875_write_benchmark_t bench = RA8875_benchmark_register_writes(&lcd, 1000);
+    printf("Register write: %" PRIu32 " ns through the driver, %" PRIu32 " ns through the fast path\n", bench.driver_ns, bench.fast_ns);
+#endif
+    Display_Configure();
+
+#if BENCHMARK_CLEARS
+    Display_BenchmarkClears();
+#endif
+#if DISPLAY_LISTS
+    Display_BuildDisplayLists();
+#if BENCHMARK_DISPLAY_LISTS
+    Display_BenchmarkDisplayLists();
+#endif
+#endif
+#if TEMPLATE_CACHE
+    Display_BuildTemplateCache();
+#if BENCHMARK_TEMPLATE_CACHE
+    Display_BenchmarkTemplateCache();
+#endif
+#endif
+    Display_Start(SCREEN_DEBUG_NO_RTD);
+    CURRENT_SCREEN = SCREEN_DEBUG_NO_RTD;
+    lastHealthCheck = xTaskGetTickCount();
 }
 
 void Display_EnableDrawMode(void) 
 {
-    if (!inGraphicMode) {
-        RA8875_write_register(&lcd, RA8875_REG_MODE_CTRL, RA8875_VAL_MODE_GRAPHIC); // Enable graphic mode if not already
-        inGraphicMode = true;
-    }
+#if DISPLAY_LISTS
+    if (recordingList) return;
+#endif
+    RA8875_write_register(&lcd, RA8875_REG_MODE_CTRL, RA8875_VAL_MODE_GRAPHIC); // Skipped by the driver if already in graphic mode
 }
 
 void Display_EnableTextModeAndFont(DisplayFont_t fontType) 
 {
     currentFont = fontType;
+#if DISPLAY_LISTS
+    if (recordingList) return;
+#endif
     if (fontType == DISPLAY_FONT_INTERNAL) {
-        if(inGraphicMode) {
-            RA8875_write_register(&lcd, RA8875_REG_MODE_CTRL, RA8875_VAL_MODE_TEXT); // Switch to text mode
-        }
-
+        RA8875_write_register(&lcd, RA8875_REG_MODE_CTRL, RA8875_VAL_MODE_TEXT); // Skipped by the driver if already in text mode
         Display_ForegroundWhite();
         Display_InternalFontSize(FONT_SIZE_TRIPLE);
     } else if (fontType == DISPLAY_FONT_COMIC_SANS) {
-        Display_EnableDrawMode(); // We write comic sans as graphical drawings
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_CGRAM
+        RA8875_write_register(&lcd, RA8875_REG_MODE_CTRL, RA8875_VAL_MODE_TEXT);
+        Display_ForegroundWhite();
+        Display_ComicSansFont();
+#else
+        Display_EnableDrawMode(); // We write comic sans as graphical drawings (rectangles or BTE)
+#endif
+    } else if (fontType == DISPLAY_FONT_SEGMENT) {
+        Display_EnableDrawMode();
     }
 }
 
 void Display_DrawRect(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color, bool filled) 
 {
+#if DISPLAY_LISTS
+    if (recordingList) {
+        if (!filled) recordingList->valid = false;  // Outlines aren't recorded
+        Display_ListAppend(DISPLAY_OP_RECT, color, x1, y1, x2, y2, NULL);
+        return;
+    }
+#endif
     RA8875_draw_rect(&lcd, x1, y1, x2, y2, color, filled);
 }
 
 void Display_WriteTextAt(uint16_t x, uint16_t y, const char* msg) 
 {
+#if DISPLAY_LISTS
+    if (recordingList) {
+        // Comic Sans glyphs can reach a full cell past their advance
+        uint16_t width = strlen(msg) * Display_CellWidth(currentFont);
+        if (currentFont == DISPLAY_FONT_COMIC_SANS) {
+            width = GLYPH_CELL_WIDTH;
+            for (const char* c = msg; *c; c++) width += glyphAdvanceComicSans[(uint8_t)*c];
+        }
+        Display_ListAppend(DISPLAY_OP_TEXT, currentFont, x, y, x + width - 1, y + Display_CellHeight(currentFont) - 1, msg);
+        return;
+    }
+#endif
     if (currentFont == DISPLAY_FONT_INTERNAL)  {
         Display_SetTextCursor(x, y);
         RA8875_write_command(&lcd, 0x02);
-
-        while (*msg) {
-            RA8875_write_data(&lcd, (uint8_t)*msg++);
-        }
+        RA8875_write_data_stream(&lcd, (const uint8_t*)msg, strlen(msg)); // The whole string in one data transaction
     } else if (currentFont == DISPLAY_FONT_COMIC_SANS) {
-        uint16_t cursorX = x;
-
-        while (*msg) {
-            uint8_t ch = (uint8_t)*msg++;
-            const Glyph8x16* glyph = glyphs[ch];
-
-            if (glyph) {
-                Display_BlitGlyph(cursorX, y, &glyph_cache[ch]);
-                cursorX += glyphAdvanceComicSans[ch];
-            }
-        }
+        Display_WriteComicSans(x, y, msg);
+    } else if (currentFont == DISPLAY_FONT_SEGMENT) {
+        Display_WriteSegments(x, y, msg);
     }
 }
 
 void Display_WriteNumberAt(uint16_t x, uint16_t y, bool isWholeNumber, float value, bool hasManyDigits) 
 { 
-    if (hasManyDigits) {
-        char buffer[11]; // Enough for "999.99999" + '\0' 
-        const char* format = "%.5f"; 
-        snprintf(buffer, sizeof(buffer), format, value); 
-        Display_WriteTextAt(x, y, buffer); 
-    } else {
-        char buffer[8]; // Enough for "999.99" + '\0' 
-        const char* format = isWholeNumber ? "%d" : "%.2f"; 
-        snprintf(buffer, sizeof(buffer), format, value); 
-        Display_WriteTextAt(x, y, buffer); 
-    }
+    char buffer[11]; // Enough for "-999.99999" + '\0' 
+    uint8_t decimals = hasManyDigits ? 5 : (isWholeNumber ? 0 : 2);
+    NumFmt_Float(buffer, sizeof(buffer), value, decimals); 
+    Display_WriteTextAt(x, y, buffer); 
 }
 
 void Display_SwitchScreen(Screen_t nextScreen) 
 {
     if (CURRENT_SCREEN == nextScreen) return;
-    
-    switch (nextScreen) {
-        case SCREEN_MAIN_NO_LAPS:
-            Display_RenderMainScreen(false);
-            break;
-        case SCREEN_MAIN_LAPS:
-            Display_RenderMainScreen(true);
-            break;
-        case SCREEN_DEBUG_NO_RTD:
-            Display_RenderStaticDebugScreen();
-            break;
-        case SCREEN_DEBUG_RTD:
-            Display_UsePrerenderedDebugRTD();
-            break;
-        case SCREEN_WARN:
-            Display_Warn();
-            break;
-        default:
-            return;
-    }
+
+    RA8875_reset_suppressed_writes(&lcd);
+    if (!Display_Render(nextScreen)) return;
 
     CURRENT_SCREEN = nextScreen;
-}
\ No newline at end of file
+#if LOG_SCREEN_SWITCHES
+    printf("Screen %d: %" PRIu32 " redundant register writes skipped\n", nextScreen, RA8875_get_suppressed_writes(&lcd));
+#if COMIC_SANS_BACKEND == COMIC_SANS_BACKEND_ATLAS
+    printf("Glyph atlas: %" PRIu32 " hits, %" PRIu32 " misses, ~%" PRIu32 " SPI bytes saved\n", atlasHits, atlasMisses, atlasBytesSaved);
+#endif
+#endif
+}
+
+void Display_UpdateValue(DisplayField_t field, float value)
+{
+    // Bit patterns rather than ==, which never holds for NaN and would redraw the field on every update
+    if (field >= FIELD_COUNT || memcmp(&fieldValues[field].number, &value, sizeof(value)) == 0) return;
+
+    fieldValues[field].number = value;
+    dirtyFields |= FIELD_BIT(field);
+}
+
+void Display_UpdateValueString(DisplayField_t field, const char* string)
+{
+    if (field >= FIELD_COUNT || strncmp(fieldValues[field].text, string, FIELD_TEXT_MAX - 1) == 0) return;
+
+    strncpy(fieldValues[field].text, string, FIELD_TEXT_MAX - 1);
+    fieldValues[field].text[FIELD_TEXT_MAX - 1] = '\0';
+    dirtyFields |= FIELD_BIT(field);
+}
+
+void Display_FlushUpdates(void)
+{
+    const ScreenSpec* spec = Display_CurrentSpec();
+    uint32_t dirty = dirtyFields;
+
+    // Fields that aren't on this screen are drawn from fieldValues whenever their screen is rendered next
+    dirtyFields = 0;
+    if (!spec || !dirty) return;
+
+    char text[MAX_SCREEN_VALUES][FIELD_TEXT_MAX];
+    Display_FormatValues(spec, dirty, text);
+    uint32_t glyphsSaved = Display_DrawValues(spec, dirty, text);
+#if LOG_VALUE_UPDATES
+    printf("Values updated: %" PRIu32 " unchanged glyphs not redrawn\n", glyphsSaved);
+#else
+    (void)glyphsSaved;
+#endif
+}
+
+void Display_RaiseWarning(const char* text, bool fullScreen, bool blink, uint32_t durationMs)
+{
+    strncpy(overlayText, text, OVERLAY_TEXT_MAX - 1);
+    overlayText[OVERLAY_TEXT_MAX - 1] = '\0';
+    overlayFullScreen = fullScreen;
+    overlayBlink = blink;
+    overlayDuration = pdMS_TO_TICKS(durationMs);
+    overlayRaisedAt = overlayToggledAt = xTaskGetTickCount();
+    overlayRaised = true;
+
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    Display_DrawOverlayPage();
+#else
+    // The second layer holds the template and atlas, or the chrome, so the warning is drawn over the screen and cleared by redrawing it. No blinking.
+    Display_DrawWarning(overlayText, overlayFullScreen);
+#endif
+}
+
+void Display_ClearWarning(void)
+{
+    if (!overlayRaised) return;
+    overlayRaised = false;
+
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    Display_ShowOverlay(false);
+#else
+    Display_Render(CURRENT_SCREEN);
+#endif
+}
+
+// Expires and blinks the warning overlay
+static void Display_ServiceOverlay(TickType_t now)
+{
+    if (!overlayRaised) return;
+
+    if (overlayDuration && now - overlayRaisedAt >= overlayDuration) {
+        Display_ClearWarning();
+        return;
+    }
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    if (overlayBlink && now - overlayToggledAt >= pdMS_TO_TICKS(OVERLAY_BLINK_MS)) {
+        overlayToggledAt = now;
+        Display_ShowOverlay(!overlayShown);
+    }
+#endif
+}
+
+void Display_SetNextScreen(Screen_t screen)
+{
+    predictedScreen = screen;
+    predictionPending = true;
+}
+
+// Prerenders the predicted screen where the next switch will find it: the hidden page, or the off-screen template
+static void Display_ServicePrediction(void)
+{
+    if (!predictionPending) return;
+    if (predictedScreen == CURRENT_SCREEN || predictedScreen >= ARRAY_LEN(screenSpecs)) {
+        predictionPending = false;
+        return;
+    }
+    const ScreenSpec* spec = &screenSpecs[predictedScreen];
+
+#if DISPLAY_LAYER_MODE == LAYER_MODE_PAGE_FLIP
+    if (overlayRaised) return;  // The hidden page holds the overlay; try again once it's cleared
+
+    uint8_t page = visiblePage ^ 1;
+    if (pageScreen[page] != (int)predictedScreen) {
+        Display_SetDrawLayer(page);
+        Display_RenderScreen(spec);
+        RA8875_wait_idle(&lcd);
+        pageScreen[page] = predictedScreen;
+        Display_SetDrawLayer(visiblePage);  // Value updates keep going to the screen that's showing
+    }
+#elif DISPLAY_LAYER_MODE == LAYER_MODE_OFFSCREEN
+    if (templateSpec != spec) Display_PrerenderTemplate(spec);
+#else
+    (void)spec;  // Both layers make up the screen that's showing, so there's nowhere to prerender
+#endif
+    predictionPending = false;
+}
+
+void Display_Service(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    Display_ServiceOverlay(now);
+    Display_ServicePrediction();
+
+    if (now - lastHealthCheck < pdMS_TO_TICKS(HEALTH_CHECK_PERIOD_MS)) return;
+    lastHealthCheck = now;
+
+    // Any error since the last check, or a sentinel register that doesn't read back, means writes are being lost
+    esp_err_t err = RA8875_take_error(&lcd);
+    if (err == ESP_OK) err = RA8875_verify(&lcd);
+    if (err == ESP_OK) return;
+
+    printf("Display error %s at %d Hz, recovering\n", esp_err_to_name(err), lcd.write_speed);
+    err = RA8875_recover(&lcd);
+    printf("SPI write clock now %d Hz, verify %s\n", lcd.write_speed, esp_err_to_name(err));
+    Display_Start(CURRENT_SCREEN);
+}
@@ -17,18 +17,63 @@ extern Screen_t CURRENT_SCREEN;
 
 typedef enum {
     DISPLAY_FONT_INTERNAL,
-    DISPLAY_FONT_COMIC_SANS
+    DISPLAY_FONT_COMIC_SANS,
+    DISPLAY_FONT_SEGMENT      // Large seven-segment digits drawn as filled rectangles, for values only
 } DisplayFont_t;
 
 typedef struct {
     uint16_t x1, y1, x2, y2;
 } LineSpec;
 
+// Every value shown on any screen. A field keeps its value across screens.
+typedef enum {
+    // Main screens
+    FIELD_LAP_DIFF,
+    FIELD_LAST_LAP_TIME,
+    FIELD_PREDICTED,
+    FIELD_PACK_PCT,
+    FIELD_LAP,
+    FIELD_DISTANCE,
+    FIELD_TORQUE_LIMIT,
+    FIELD_TC_LAT_MODE,
+    FIELD_TV_BALANCE,
+
+    // Debug screens
+    FIELD_LV_VOLTAGE,
+    FIELD_GPS_LONG,
+    FIELD_GPS_LAT,
+    FIELD_PACK_VOLTAGE,
+    FIELD_MOTOR_T_MAX,
+    FIELD_MOTOR_T_MAX_CORNER, // String, i.e. "RR"
+    FIELD_APP_ARB,
+    FIELD_TORQUE_RQ_AVG,
+    FIELD_ROTOR_T,
+    FIELD_INV_T_MAX,
+    FIELD_INV_T_MAX_CORNER,   // String, i.e. "RR"
+    FIELD_STEER_ANGLE,
+    FIELD_F_BRAKE_BIAS,
+    FIELD_LOGGING,
+    FIELD_MIN_CELL_V,
+    FIELD_MIN_CELL_V_INDEX,
+    FIELD_PEAK_CELL_T,
+    FIELD_PEAK_CELL_T_INDEX,
+    FIELD_F_BRAKE_PRESS,
+    FIELD_POWER_LIMIT,
+
+    FIELD_COUNT
+} DisplayField_t;
+
 // Initialization
 void Display_Init(void);
+void Display_Service(void); // Call every loop; blinks and expires warnings, and checks for lost SPI writes about once a second and recovers at a slower clock
+
+// Warning overlay, mixed over the current screen without redrawing it. durationMs 0 keeps it up until Display_ClearWarning.
+void Display_RaiseWarning(const char* text, bool fullScreen, bool blink, uint32_t durationMs);
+void Display_ClearWarning(void);
 
 // Display screens
 void Display_SwitchScreen(Screen_t nextScreen); 
+void Display_SetNextScreen(Screen_t screen); // The screen most likely to be switched to next; Display_Service prerenders it while idle
 
 // Write Mode Switching
 void Display_EnableDrawMode(void);
@@ -39,6 +84,8 @@ void Display_DrawRect(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_
 void Display_WriteTextAt(uint16_t x, uint16_t y, const char* msg);
 void Display_WriteNumberAt(uint16_t x, uint16_t y, bool isWholeNumber, float value, bool hasManyDigits);
 
-// Updating Values!!! TBD
-// void Display_UpdateValueString(maybe-some-typedef-for-which-value-is-being-updated, const char* string); // i.e. "RR" in Motor T Max and Inv T Max
-// void Display_UpdateValue(maybe-some-typedef-for-which-value-is-being-updated, float value); // everything else
\ No newline at end of file
+// Updating Values
+// Updates only store the value and mark the field dirty. Display_FlushUpdates redraws the dirty fields on the current screen.
+void Display_UpdateValueString(DisplayField_t field, const char* string); // i.e. "RR" in Motor T Max and Inv T Max
+void Display_UpdateValue(DisplayField_t field, float value); // everything else
+void Display_FlushUpdates(void);
\ No newline at end of file
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+Generates comicsans_rects.h: a flash-resident table of filled rectangles covering
+every glyph in comicsans_font.h, used by the COMIC_SANS_BACKEND_SPANS renderer.
+
+Each glyph gets the smallest of three covers: vertical column runs merged across
+identical neighbouring columns, horizontal row runs merged across identical
+neighbouring rows, and a greedy cover with maximal all-lit rectangles (overlaps
+allowed). All three are no worse than the original one-rectangle-per-column-run.
+
+Usage: gen_glyph_rects.py <comicsans_font.h> <comicsans_rects.h> [--report]
+"""
+
+import re
+import sys
+
+GLYPH_W = 8
+GLYPH_H = 16
+
+GLYPH_RE = re.compile(r"static const Glyph8x16 glyph_(\d+)\s*=\s*\{\s*\.bitmap\s*=\s*\{([^}]*)\}", re.S)
+TABLE_RE = re.compile(r"\[\s*(\d+)\]\s*=\s*&glyph_(\d+)")
+
+
+def parse_font(path):
+    with open(path) as f:
+        text = f.read()
+    bitmaps = {}
+    for name, body in GLYPH_RE.findall(text):
+        rows = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", body)]
+        if len(rows) != GLYPH_H:
+            raise ValueError("glyph_%s has %d rows, expected %d" % (name, len(rows), GLYPH_H))
+        bitmaps[int(name)] = rows
+    return {int(ch): bitmaps[int(name)] for ch, name in TABLE_RE.findall(text)}
+
+
+def pixels(rows):
+    return {(x, y) for y, bits in enumerate(rows) for x in range(GLYPH_W) if bits & (0x80 >> x)}
+
+
+def column_runs(lit):
+    """Rectangle count of the original renderer: one per vertical run in each column."""
+    count = 0
+    for x in range(GLYPH_W):
+        prev = False
+        for y in range(GLYPH_H):
+            cur = (x, y) in lit
+            if cur and not prev:
+                count += 1
+            prev = cur
+    return count
+
+
+def merged_runs(lit, vertical):
+    """Runs along one axis, with identical runs on neighbouring lines merged into one rectangle."""
+    lines, span = (GLYPH_W, GLYPH_H) if vertical else (GLYPH_H, GLYPH_W)
+    at = (lambda line, i: (line, i)) if vertical else (lambda line, i: (i, line))
+    open_runs = {}
+    rects = []
+    for line in range(lines + 1):
+        runs = set()
+        i = 0
+        while line < lines and i < span:
+            if at(line, i) in lit:
+                start = i
+                while i < span and at(line, i) in lit:
+                    i += 1
+                runs.add((start, i - start))
+            else:
+                i += 1
+        for run in list(open_runs):
+            if run not in runs:
+                first = open_runs.pop(run)
+                if vertical:
+                    rects.append((first, run[0], line - first, run[1]))
+                else:
+                    rects.append((run[0], first, run[1], line - first))
+        for run in runs:
+            open_runs.setdefault(run, line)
+    return rects
+
+
+def all_rects(lit):
+    """Every rectangle made only of lit pixels, as (x, y, w, h)."""
+    rects = []
+    for y in range(GLYPH_H):
+        for x in range(GLYPH_W):
+            if (x, y) not in lit:
+                continue
+            max_w = GLYPH_W - x
+            for h in range(1, GLYPH_H - y + 1):
+                w = 0
+                while w < max_w and (x + w, y + h - 1) in lit:
+                    w += 1
+                max_w = w
+                if not max_w:
+                    break
+                for rw in range(1, max_w + 1):
+                    rects.append((x, y, rw, h))
+    return rects
+
+
+def greedy_cover(lit):
+    """Greedy set cover: repeatedly take the rectangle covering the most still-uncovered pixels."""
+    candidates = [(r, {(r[0] + dx, r[1] + dy) for dx in range(r[2]) for dy in range(r[3])}) for r in all_rects(lit)]
+    uncovered = set(lit)
+    chosen = []
+    while uncovered:
+        best, best_cells = max(candidates, key=lambda c: (len(c[1] & uncovered), len(c[1])))
+        chosen.append(best)
+        uncovered -= best_cells
+    return chosen
+
+
+def cover(lit):
+    best = min((merged_runs(lit, True), merged_runs(lit, False), greedy_cover(lit)), key=len)
+    return sorted(best, key=lambda r: (r[1], r[0]))
+
+
+def pack(rect):
+    x, y, w, h = rect
+    return (x << 11) | (y << 7) | ((w - 1) << 4) | (h - 1)
+
+
+def describe(ch):
+    return repr(chr(ch)) if 32 <= ch < 127 else str(ch)
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 1
+
+    font = parse_font(argv[1])
+    report = "--report" in argv[3:]
+
+    packed = []
+    offsets = []
+    lines = []
+    before_total = after_total = 0
+    for ch in range(256):
+        offsets.append(len(packed))
+        if ch not in font:
+            continue
+        lit = pixels(font[ch])
+        rects = cover(lit)
+        before = column_runs(lit)
+        before_total += before
+        after_total += len(rects)
+        packed.extend(pack(r) for r in rects)
+        lines.append("%-5s %3d -> %3d" % (describe(ch), before, len(rects)))
+    offsets.append(len(packed))
+
+    summary = "%d glyphs, %d -> %d rectangles" % (len(font), before_total, after_total)
+    if report:
+        print("glyph column runs -> cover")
+        print("\n".join(lines))
+        print(summary)
+
+    out = []
+    out.append("// Generated by gen_glyph_rects.py from comicsans_font.h. Do not edit.")
+    out.append("// Rectangles per glyph (column runs -> cover):")
+    out.extend("//   " + line for line in lines)
+    out.append("//   " + summary)
+    out.append("")
+    out.append("#pragma once")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append("// Packed rectangle in unscaled glyph pixels: x[13:11] y[10:7] (w-1)[6:4] (h-1)[3:0]")
+    out.append("#define GLYPH_RECT_X(r) (((r) >> 11) & 0x7)")
+    out.append("#define GLYPH_RECT_Y(r) (((r) >> 7) & 0xF)")
+    out.append("#define GLYPH_RECT_W(r) ((((r) >> 4) & 0x7) + 1)")
+    out.append("#define GLYPH_RECT_H(r) (((r) & 0xF) + 1)")
+    out.append("")
+    out.append("static const uint16_t glyphRects[%d] = {" % max(len(packed), 1))
+    for i in range(0, len(packed), 12):
+        out.append("    " + ", ".join("0x%04X" % v for v in packed[i:i + 12]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("// Rectangles for character ch are glyphRects[glyphRectOffset[ch]] up to glyphRectOffset[ch + 1]")
+    out.append("static const uint16_t glyphRectOffset[257] = {")
+    for i in range(0, len(offsets), 16):
+        out.append("    " + ", ".join("%d" % v for v in offsets[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+
+    with open(argv[2], "w") as f:
+        f.write("\n".join(out))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
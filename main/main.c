@@ -10,30 +10,40 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+// Where the submode button goes from each drive screen
+static Screen_t NextDuringDrive(Screen_t screen) {
+    switch (screen) {
+        case SCREEN_MAIN_NO_LAPS: return SCREEN_MAIN_LAPS;
+        case SCREEN_MAIN_LAPS:    return SCREEN_DEBUG_RTD;
+        case SCREEN_DEBUG_RTD:    return SCREEN_MAIN_NO_LAPS;
+        default:                  return screen;
+    }
+}
+
+// The screen the next button press most likely shows: the mode button from the non-RTD debug screen, otherwise the submode cycle
+static Screen_t PredictNextScreen(void) {
+    if (CURRENT_SCREEN == SCREEN_DEBUG_NO_RTD) return SCREEN_MAIN_NO_LAPS;
+    return NextDuringDrive(CURRENT_SCREEN);
+}
+
 static void ToggleWhetherDrive(void) {
     if (CURRENT_SCREEN == SCREEN_DEBUG_NO_RTD) {
         Display_SwitchScreen(SCREEN_MAIN_NO_LAPS);
     } else { 
         Display_SwitchScreen(SCREEN_DEBUG_NO_RTD);
     }
+    Display_SetNextScreen(PredictNextScreen());
 }
 
 static void ToggleDuringDrive(void) {
-    switch (CURRENT_SCREEN) {
-        case SCREEN_MAIN_NO_LAPS:
-            Display_SwitchScreen(SCREEN_MAIN_LAPS);
-            break;
-        case SCREEN_MAIN_LAPS:
-            Display_SwitchScreen(SCREEN_WARN);
-            vTaskDelay(pdMS_TO_TICKS(500));
-            Display_SwitchScreen(SCREEN_DEBUG_RTD);
-            break;
-        case SCREEN_DEBUG_RTD:
-            Display_SwitchScreen(SCREEN_MAIN_NO_LAPS);
-            break;
-        default:
-            break;
+    Screen_t next = NextDuringDrive(CURRENT_SCREEN);
+    if (next == CURRENT_SCREEN) return;
+
+    Display_SwitchScreen(next);
+    if (next == SCREEN_DEBUG_RTD) {
+        Display_RaiseWarning("WARNING", true, false, 500); // Cleared by Display_Service
     }
+    Display_SetNextScreen(PredictNextScreen());
 }
 
 void app_main(void) 
@@ -43,6 +53,7 @@ void app_main(void)
 
     // Init
     Display_Init(); // Defaults to static debug screen
+    Display_SetNextScreen(PredictNextScreen()); // Prerendered by Display_Service while nothing else is happening
     Controller_Init();
 
     while (1) {
@@ -57,6 +68,9 @@ void app_main(void)
             }
         }
 
+        Display_FlushUpdates(); // Redraws whichever values changed since the last pass
+        Display_Service();      // Recovers the display if SPI writes are getting lost
+
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+* Author: Richard Li
+* Editors: Richard Li
+*
+* Host benchmark against snprintf:
+*     gcc -O2 -DNUMFMT_BENCHMARK main/numfmt.c -o numfmt_bench -lm && ./numfmt_bench
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include "numfmt.h"
+
+static const uint32_t powersOf10[NUMFMT_MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static size_t NumFmt_Copy(char* buffer, size_t size, const char* text, size_t len)
+{
+    if (size == 0) return 0;
+    if (len > size - 1) len = size - 1;
+
+    for (size_t i = 0; i < len; ++i) {
+        buffer[i] = text[i];
+    }
+    buffer[len] = '\0';
+    return len;
+}
+
+// Digits are produced right to left into a scratch buffer, fraction first
+static size_t NumFmt_Emit(char* buffer, size_t size, bool negative, uint32_t whole, uint32_t fraction, uint8_t decimals)
+{
+    char digits[NUMFMT_MAX_LEN];
+    char* p = digits + sizeof(digits);
+
+    for (uint8_t i = 0; i < decimals; ++i) {
+        *--p = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    if (decimals) *--p = '.';
+
+    do {
+        *--p = '0' + whole % 10;
+        whole /= 10;
+    } while (whole);
+
+    if (negative) *--p = '-';
+    return NumFmt_Copy(buffer, size, p, digits + sizeof(digits) - p);
+}
+
+size_t NumFmt_Int(char* buffer, size_t size, int32_t value)
+{
+    return NumFmt_Fixed(buffer, size, value, 0);
+}
+
+size_t NumFmt_Fixed(char* buffer, size_t size, int32_t scaled, uint8_t decimals)
+{
+    if (decimals > NUMFMT_MAX_DECIMALS) decimals = NUMFMT_MAX_DECIMALS;
+
+    bool negative = scaled < 0;
+    uint32_t magnitude = negative ? 0u - (uint32_t)scaled : (uint32_t)scaled;
+    return NumFmt_Emit(buffer, size, negative, magnitude / powersOf10[decimals], magnitude % powersOf10[decimals], decimals);
+}
+
+size_t NumFmt_Float(char* buffer, size_t size, float value, uint8_t decimals)
+{
+    if (decimals > NUMFMT_MAX_DECIMALS) decimals = NUMFMT_MAX_DECIMALS;
+    if (isnan(value)) return NumFmt_Copy(buffer, size, "nan", 3);
+
+    bool negative = value < 0;
+    float magnitude = fabsf(value);
+    if (magnitude >= 4294967296.0f) {
+        return NumFmt_Emit(buffer, size, negative, UINT32_MAX, powersOf10[decimals] - 1, decimals); // Clamped, also covers inf
+    }
+
+    // Splitting off the whole part is exact, so the only rounding is on the fraction
+    uint32_t whole = (uint32_t)magnitude;
+    uint32_t fraction = (uint32_t)((magnitude - (float)whole) * (float)powersOf10[decimals] + 0.5f);
+    if (fraction >= powersOf10[decimals]) {
+        fraction -= powersOf10[decimals];
+        whole++;
+    }
+
+    // Don't print "-0.00" for values that round to zero
+    if (whole == 0 && fraction == 0) negative = false;
+    return NumFmt_Emit(buffer, size, negative, whole, fraction, decimals);
+}
+
+#ifdef NUMFMT_BENCHMARK
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_VALUES     4096
+#define BENCH_ITERATIONS 200
+
+static double Bench_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void Bench_Run(const char* name, const float* values, uint8_t decimals)
+{
+    char expected[32], actual[32];
+    char format[8];
+    volatile size_t sink = 0;
+    int mismatches = 0;
+
+    snprintf(format, sizeof(format), "%%.%uf", decimals);
+
+    double start = Bench_Now();
+    for (int it = 0; it < BENCH_ITERATIONS; ++it) {
+        for (int i = 0; i < BENCH_VALUES; ++i) {
+            sink += snprintf(expected, sizeof(expected), format, values[i]);
+        }
+    }
+    double printfTime = Bench_Now() - start;
+
+    start = Bench_Now();
+    for (int it = 0; it < BENCH_ITERATIONS; ++it) {
+        for (int i = 0; i < BENCH_VALUES; ++i) {
+            sink += NumFmt_Float(actual, sizeof(actual), values[i], decimals);
+        }
+    }
+    double numfmtTime = Bench_Now() - start;
+
+    // Differences can only be last-digit rounding ties, where snprintf rounds the exact binary value
+    for (int i = 0; i < BENCH_VALUES; ++i) {
+        snprintf(expected, sizeof(expected), format, values[i]);
+        NumFmt_Float(actual, sizeof(actual), values[i], decimals);
+        if (strcmp(expected, actual) != 0 && strcmp(expected + 1, actual) != 0) { // "-0.00" vs "0.00" is intended
+            if (mismatches++ < 3) printf("  %s: snprintf \"%s\" numfmt \"%s\"\n", name, expected, actual);
+        }
+    }
+
+    double calls = (double)BENCH_ITERATIONS * BENCH_VALUES;
+    printf("%-14s snprintf %6.1f ns/call  numfmt %6.1f ns/call  %5.1fx  %d/%d last-digit differences\n",
+           name, printfTime / calls * 1e9, numfmtTime / calls * 1e9, printfTime / numfmtTime, mismatches, BENCH_VALUES);
+    (void)sink;
+}
+
+int main(void)
+{
+    static float gps[BENCH_VALUES], twoDecimals[BENCH_VALUES];
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < BENCH_VALUES; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        gps[i] = (float)((int32_t)((seed >> 7) % 36000001) - 18000000) / 100000.0f;  // -180.00000 to 180.00000
+        seed = seed * 1664525u + 1013904223u;
+        twoDecimals[i] = (float)((int32_t)((seed >> 8) % 199999) - 99999) / 100.0f;  // -999.99 to 999.99
+    }
+
+    Bench_Run("GPS (%.5f)", gps, 5);
+    Bench_Run("Value (%.2f)", twoDecimals, 2);
+    return 0;
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Number formatting for the display, without printf: no varargs, no locale, no float printf from newlib.
+// Each function writes a NUL-terminated string into buffer (truncated to fit size, like snprintf) and returns its length.
+
+#define NUMFMT_MAX_DECIMALS 9
+#define NUMFMT_MAX_LEN      22  // "-4294967295.999999999" + '\0'
+
+// Whole number, i.e. -42 -> "-42"
+size_t NumFmt_Int(char* buffer, size_t size, int32_t value);
+
+// Scaled integer with a fixed number of decimals, i.e. (31245, 2) -> "312.45"
+size_t NumFmt_Fixed(char* buffer, size_t size, int32_t scaled, uint8_t decimals);
+
+// Float rounded half away from zero to a fixed number of decimals, i.e. (-122.015625f, 3) -> "-122.016"
+size_t NumFmt_Float(char* buffer, size_t size, float value, uint8_t decimals);